@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+
+# Copyright (c) 2024-present, Trail of Bits, Inc.
+
+"""
+Measures startup cost of vast-front: an empty translation unit is pushed
+through `-vast-emit-mlir=hl` repeatedly, which is dominated by the setup of
+the compiler and the MLIR context.
+"""
+
+import argparse
+import json
+import os
+import resource
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+
+def run_once(vast_front, source, output):
+    cmd = [vast_front, "-vast-emit-mlir=hl", source, "-o", output]
+    start = time.perf_counter()
+    subprocess.run(cmd, check=True)
+    return time.perf_counter() - start
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--vast-front", required=True, help="path to vast-front")
+    parser.add_argument("--runs", type=int, default=20, help="number of measured runs")
+    parser.add_argument("--warmup", type=int, default=2, help="number of unmeasured runs")
+    parser.add_argument("--output", help="write results as JSON to this file")
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as tmp:
+        source = os.path.join(tmp, "empty.c")
+        output = os.path.join(tmp, "empty.mlir")
+        open(source, "w").close()
+
+        for _ in range(args.warmup):
+            run_once(args.vast_front, source, output)
+
+        times = [run_once(args.vast_front, source, output) for _ in range(args.runs)]
+
+    # Linux reports the maximum resident set size in kilobytes.
+    peak_rss = resource.getrusage(resource.RUSAGE_CHILDREN).ru_maxrss * 1024
+
+    result = {
+        "benchmark": "startup",
+        "runs": args.runs,
+        "min_s": min(times),
+        "median_s": statistics.median(times),
+        "mean_s": statistics.mean(times),
+        "peak_rss_bytes": peak_rss,
+    }
+
+    print(
+        f"startup: median {result['median_s'] * 1000:.1f} ms, "
+        f"min {result['min_s'] * 1000:.1f} ms, "
+        f"peak rss {peak_rss / (1 << 20):.1f} MiB over {args.runs} runs"
+    )
+
+    if args.output:
+        with open(args.output, "w") as out:
+            json.dump(result, out, indent=2)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,273 @@
+#!/usr/bin/env python3
+
+# Copyright (c) 2024-present, Trail of Bits, Inc.
+
+"""
+Measures end-to-end throughput of vast-front on synthetic C workloads. Each
+workload is compiled with `-vast-emit-llvm`, i.e., pushed through code
+generation, every step of the conversion pipeline, translation to LLVM IR
+and the LLVM backend. Time, CPU time, operation counts and resident memory
+of each phase are taken from `-vast-pass-statistics`, the peak resident
+memory of the whole compilation from the operating system.
+
+Results are written as JSON, a previous result can be passed as a baseline
+to print relative changes, e.g., between commits.
+"""
+
+import argparse
+import json
+import os
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+
+#
+# workloads
+#
+
+def deep_nesting(scale):
+    depth = 48 * scale
+    lines = ["int nested(int x) {", "    int acc = 0;"]
+    for i in range(depth):
+        indent = "    " * (i + 1)
+        lines.append(f"{indent}if (x > {i}) {{")
+        lines.append(f"{indent}    acc += {i};")
+    for i in reversed(range(depth)):
+        lines.append("    " * (i + 1) + "}")
+    lines += ["    return acc;", "}"]
+    return "\n".join(lines) + "\n"
+
+
+def many_structs(scale):
+    count = 200 * scale
+    out = []
+    for i in range(count):
+        out.append(f"struct s{i} {{ int a; long b; char c[{i % 7 + 1}]; }};")
+        out.append(f"long get{i}(struct s{i} *s) {{ return s->a + s->b + s->c[0]; }}")
+    return "\n".join(out) + "\n"
+
+
+def many_typedefs(scale):
+    count = 400 * scale
+    out = ["typedef int t0;"]
+    for i in range(1, count):
+        out.append(f"typedef t{i - 1} t{i};")
+    out.append(f"t{count - 1} last(t{count - 1} x) {{ return x + 1; }}")
+    return "\n".join(out) + "\n"
+
+
+def huge_switch(scale):
+    cases = 1000 * scale
+    lines = ["int dispatch(int x) {", "    switch (x) {"]
+    for i in range(cases):
+        lines.append(f"        case {i}: return x * {i % 13} + {i};")
+    lines += ["        default: return -1;", "    }", "}"]
+    return "\n".join(lines) + "\n"
+
+
+def long_functions(scale):
+    statements = 2000 * scale
+    lines = ["int long_function(int x, int y) {", "    int acc = 0;"]
+    for i in range(statements):
+        op = "+-*^"[i % 4]
+        lines.append(f"    acc = acc {op} (x + {i}) * (y - {i % 17});")
+    lines += ["    return acc;", "}"]
+    return "\n".join(lines) + "\n"
+
+
+def many_small_functions(scale):
+    count = 2000 * scale
+    out = []
+    for i in range(count):
+        out.append(f"int f{i}(int x) {{ return x + {i}; }}")
+    return "\n".join(out) + "\n"
+
+
+def many_call_sites(scale):
+    # 100k call sites, each of them asks for the mangled name of the callee.
+    # They are split among callers to measure the name lookup rather than
+    # the size of a single function.
+    callers, calls = 100 * scale, 1000
+    lines = ["int callee(int x, int y);"]
+    for c in range(callers):
+        lines += [f"int caller{c}(int x) {{", "    int acc = 0;"]
+        for i in range(calls):
+            lines.append(f"    acc += callee(x, {i});")
+        lines += ["    return acc;", "}"]
+    return "\n".join(lines) + "\n"
+
+
+WORKLOADS = {
+    "deep-nesting": deep_nesting,
+    "many-structs": many_structs,
+    "many-typedefs": many_typedefs,
+    "huge-switch": huge_switch,
+    "long-functions": long_functions,
+    "many-small-functions": many_small_functions,
+    "many-call-sites": many_call_sites,
+}
+
+
+#
+# measurement
+#
+
+def run_once(vast_front, source, output, stats_path, extra):
+    cmd = [
+        vast_front, "-vast-emit-llvm", f"-vast-pass-statistics={stats_path}",
+        *extra, source, "-o", output,
+    ]
+
+    start = time.perf_counter()
+    proc = subprocess.Popen(cmd)
+    _, status, usage = os.wait4(proc.pid, 0)
+    wall = time.perf_counter() - start
+    proc.returncode = os.waitstatus_to_exitcode(status)
+
+    if proc.returncode != 0:
+        raise subprocess.CalledProcessError(proc.returncode, cmd)
+
+    with open(stats_path) as stats:
+        steps = json.load(stats)["steps"]
+
+    # Linux reports the maximum resident set size in kilobytes.
+    return wall, usage.ru_maxrss * 1024, steps
+
+
+def summarize_phases(runs):
+    """Medians of pipeline steps and phases over runs, in order of execution."""
+    phases = {}
+    for steps in runs:
+        for step in steps:
+            # Passes are summarized by the steps they belong to.
+            if step["kind"] not in ("compound", "phase"):
+                continue
+            phases.setdefault(step["name"], []).append(step)
+
+    result = []
+    for name, samples in phases.items():
+        wall = statistics.median(s["wall"] for s in samples)
+        cpu = statistics.median(s.get("cpu", 0) for s in samples)
+        ops = samples[0]["ops_before"] or samples[0]["ops_after"]
+        result.append({
+            "name": name,
+            "kind": samples[0]["kind"],
+            "wall_s": wall,
+            "cpu_s": cpu,
+            "ops_before": samples[0]["ops_before"],
+            "ops_after": samples[0]["ops_after"],
+            "ops_per_s": ops / wall if ops and wall > 0 else None,
+            "rss_delta_bytes": max(s.get("rss_delta", 0) for s in samples),
+        })
+    return result
+
+
+def measure(args, name, source):
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, f"{name}.c")
+        with open(path, "w") as out:
+            out.write(source)
+
+        output = os.path.join(tmp, f"{name}.ll")
+        stats = os.path.join(tmp, f"{name}.json")
+
+        for _ in range(args.warmup):
+            run_once(args.vast_front, path, output, stats, args.extra)
+
+        runs = [run_once(args.vast_front, path, output, stats, args.extra) for _ in range(args.runs)]
+
+    times = [wall for wall, _, _ in runs]
+    phases = summarize_phases([steps for _, _, steps in runs])
+    codegen = next((p for p in phases if p["name"] == "codegen"), None)
+    ops = codegen["ops_after"] if codegen else None
+    median = statistics.median(times)
+
+    return {
+        "workload": name,
+        "source_bytes": len(source),
+        "runs": args.runs,
+        "min_s": min(times),
+        "median_s": median,
+        "peak_rss_bytes": max(rss for _, rss, _ in runs),
+        "hl_ops": ops,
+        "hl_ops_per_s": ops / median if ops else None,
+        "phases": phases,
+    }
+
+
+#
+# reporting
+#
+
+def relative(current, baseline):
+    if not baseline:
+        return ""
+    return f" ({(current - baseline) / baseline * 100:+.1f}%)"
+
+
+def report(result, baseline):
+    base = baseline.get(result["workload"], {})
+    base_phases = {p["name"]: p for p in base.get("phases", [])}
+
+    print(
+        f"{result['workload']}: median {result['median_s'] * 1000:.1f} ms"
+        f"{relative(result['median_s'], base.get('median_s'))}, "
+        f"peak rss {result['peak_rss_bytes'] / (1 << 20):.1f} MiB"
+        f"{relative(result['peak_rss_bytes'], base.get('peak_rss_bytes'))}"
+    )
+
+    for phase in result["phases"]:
+        ops_per_s = phase["ops_per_s"]
+        rate = f", {ops_per_s:.0f} ops/s" if ops_per_s else ""
+        previous = base_phases.get(phase["name"], {}).get("wall_s")
+        print(
+            f"  {phase['name']:<20} {phase['wall_s'] * 1000:10.2f} ms"
+            f"{relative(phase['wall_s'], previous)}{rate}"
+        )
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--vast-front", required=True, help="path to vast-front")
+    parser.add_argument("--runs", type=int, default=5, help="number of measured runs")
+    parser.add_argument("--warmup", type=int, default=1, help="number of unmeasured runs")
+    parser.add_argument("--scale", type=int, default=1, help="size multiplier of the workloads")
+    parser.add_argument(
+        "--workload", action="append", choices=sorted(WORKLOADS),
+        help="run only the given workload, can be repeated"
+    )
+    parser.add_argument("--baseline", help="previous JSON result to compare with")
+    parser.add_argument("--output", help="write results as JSON to this file")
+    parser.add_argument(
+        "extra", nargs="*", help="additional vast-front options after `--`, e.g., -- -vast-disable-multithreading"
+    )
+    args = parser.parse_args()
+
+    baseline = {}
+    if args.baseline:
+        with open(args.baseline) as previous:
+            baseline = {w["workload"]: w for w in json.load(previous)["workloads"]}
+
+    results = []
+    for name in args.workload or WORKLOADS:
+        result = measure(args, name, WORKLOADS[name](args.scale))
+        report(result, baseline)
+        results.append(result)
+
+    if args.output:
+        with open(args.output, "w") as out:
+            json.dump({
+                "benchmark": "throughput",
+                "scale": args.scale,
+                "options": args.extra,
+                "workloads": results,
+            }, out, indent=2)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -17,6 +17,7 @@ VAST_UNRELAX_WARNINGS
 #include "vast/Util/Common.hpp"
 
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <variant>
@@ -220,12 +221,15 @@ namespace vast::abi
         args_info_t _args;
 
         // calling convention.
-        RawFn raw_fn;
+        // Only the type of the function is kept, the function itself may be
+        // replaced while the info is still in use.
+        using fn_type_t = decltype( std::declval< RawFn >().getFunctionType() );
+        fn_type_t _fn_type;
 
         using type = typename arg_info::type;
         using types = typename arg_info::types;
 
-        func_info( RawFn raw_fn ) : raw_fn( raw_fn ) {}
+        func_info( RawFn raw_fn ) : _fn_type( raw_fn.getFunctionType() ) {}
 
         std::string to_string() const
         {
@@ -251,12 +255,12 @@ namespace vast::abi
             _args.emplace_back( std::move( i ) );
         }
 
-        auto fn_type()
+        auto fn_type() const
         {
-            return raw_fn.getFunctionType();
+            return _fn_type;
         }
 
-        auto return_type()
+        auto return_type() const
         {
             auto results = fn_type().getResults();
             VAST_CHECK( results.size() == 1, "Cannot handle more return types." );
@@ -270,11 +274,11 @@ namespace vast::abi
     template< typename Op >
     func_info( Op ) -> func_info< Op >;
 
-    template< typename Fn, typename Classifier, typename DL >
-    func_info< Fn > make( Fn fn, const DL &dl )
+    template< typename Fn, typename Classifier, typename DL, typename ... Args >
+    func_info< Fn > make( Fn fn, const DL &dl, Args && ... args )
     {
         auto info = func_info( fn );
-        return Classifier( info, dl ).compute_abi().take();
+        return Classifier( info, dl, std::forward< Args >( args ) ... ).compute_abi().take();
     }
 
 } // namespace vast::abi
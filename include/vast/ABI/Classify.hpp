@@ -9,6 +9,7 @@ VAST_RELAX_WARNINGS
 VAST_UNRELAX_WARNINGS
 
 #include "vast/ABI/ABI.hpp"
+#include "vast/ABI/Layout.hpp"
 
 #include "vast/Dialect/HighLevel/HighLevelUtils.hpp"
 
@@ -136,35 +137,52 @@ namespace vast::abi
         // TODO(abi): Will need to live in a different interface.
         static std::size_t pointer_size() { return 64; }
 
-        static std::size_t size( const auto &dl, mlir::Type t )
+        // `ctx` is the `type_layouts` of the classification.
+        static std::size_t size( const auto &ctx, mlir::Type t )
         {
-            return dl.getTypeSizeInBits( t );
+            return ctx.size( t );
         }
 
         // [ start, end )
         static bool bits_contain_no_user_data( mlir::Type t, std::size_t start,
                                                std::size_t end, const auto &ctx )
         {
-            const auto &[ dl, op ] = ctx;
-
-            if ( size( dl, t ) <= start )
+            if ( size( ctx, t ) <= start )
                 return true;
 
+            // Elements and fields are checked in their own bits, i.e., the range
+            // is shifted by their offset.
+            auto contains_no_user_data = [ & ]( mlir::Type elem, std::size_t offset )
+            {
+                auto elem_start = offset < start ? start - offset : 0;
+                return bits_contain_no_user_data( elem, elem_start, end - offset, ctx );
+            };
+
             if ( is_array( t ) )
-                VAST_TODO( "bits_contain_no_user_data, array: {0}", t );
+            {
+                auto array = mlir::cast< hl::ArrayType >( maybe_strip< hl::ElaboratedType >( t ) );
+                auto elem = array.getElementType();
+                auto elem_size = size( ctx, elem );
+                for ( std::size_t idx = 0; idx < array.getSize().value_or( 0 ); ++idx )
+                {
+                    auto offset = idx * elem_size;
+                    if ( offset >= end )
+                        break;
+                    if ( !contains_no_user_data( elem, offset ) )
+                        return false;
+                }
+                return true;
+            }
 
             if ( is_record( t ) )
             {
                 // TODO(abi): CXXRecordDecl.
-                std::size_t current = 0;
-                for ( auto field : fields( t, op ) )
+                for ( const auto &field : ctx.layout( t ).fields )
                 {
-                    if ( current >= end )
+                    if ( field.offset >= end )
                         break;
-                    if ( !bits_contain_no_user_data( field, current, end - start, ctx ) )
+                    if ( !contains_no_user_data( field.type, field.offset ) )
                         return false;
-
-                    current += size( dl, t );
                 }
                 return true;
             }
@@ -181,14 +199,12 @@ namespace vast::abi
                                               mlir::Type root, std::size_t root_offset,
                                               const auto &ctx )
         {
-            const auto &[ dl, _ ] = ctx;
             //if ( offset != 0 )
             //    VAST_TODO( "int_type_at_offset called with {0}.", offset );
 
             auto is_int_type = [ & ]( std::size_t trg_size )
             {
-                const auto &[ dl_, _ ] = ctx;
-                return is_scalar_integer( t ) && size( dl_, t ) == trg_size;
+                return is_scalar_integer( t ) && size( ctx, t ) == trg_size;
             };
 
 
@@ -202,7 +218,7 @@ namespace vast::abi
             {
                 // TODO(abi): Here should be check if `BitsContainNoUserData` - however
                 //            for now it should be safe to always pretend to it being `false`?
-                if ( bits_contain_no_user_data( root, offset + size( dl, t ),
+                if ( bits_contain_no_user_data( root, offset + size( ctx, t ),
                                                 root_offset + 64, ctx ) )
                 {
                     return t;
@@ -212,7 +228,7 @@ namespace vast::abi
             // We need to extract a field on current offset.
             // TODO(abi): This is done differently than clang, since they seem to be using
             //            underflow? on offset?
-            if ( is_struct( t ) && ( size( dl, t )  > 64 ) )
+            if ( is_struct( t ) && ( size( ctx, t )  > 64 ) )
             {
                 auto [ field, field_start ] = field_containing_offset( ctx, t, offset );
                 VAST_ASSERT( field );
@@ -222,7 +238,7 @@ namespace vast::abi
             if ( is_array( t ) )
                 VAST_TODO( "int_type_at_offset in {0} (is_array_was_true", t );
 
-            auto type_size = size( dl, root );
+            auto type_size = size( ctx, root );
             VAST_CHECK( type_size != 0, "Unexpected empty field? Type: {0}", t );
 
             auto final_size = std::min< std::size_t >( type_size - ( root_offset * 8 ), 64 );
@@ -235,23 +251,9 @@ namespace vast::abi
         static auto field_containing_offset( const auto &ctx, mlir::Type t, std::size_t offset )
             -> std::tuple< mlir::Type, std::size_t >
         {
-            const auto &[ dl, op ] = ctx;
-
-            auto curr = 0;
-            for ( auto field : fields( t, op ) )
-            {
-                if ( curr + size( dl, field ) > offset )
-                    return { field, curr };
-                curr += size( dl, field );
-            }
+            if ( auto field = ctx.layout( t ).field_containing( offset ) )
+                return { field->type, field->offset };
             VAST_UNREACHABLE( "Did not find field at offset {0} in {1}", offset,t );
-
-        }
-
-        static auto fields(mlir_type type, auto func)
-        {
-            auto mod = func->template getParentOfType< vast_module >();
-            return vast::hl::field_types(type, mod);
         }
     };
 
@@ -271,7 +273,7 @@ namespace vast::abi
         using types = typename func_info::types;
 
         func_info info;
-        const data_layout &dl;
+        const type_layouts< data_layout > &layouts;
 
         static constexpr std::size_t max_gpr = 6;
         static constexpr std::size_t max_sse = 8;
@@ -279,14 +281,13 @@ namespace vast::abi
         std::size_t needed_int = 0;
         std::size_t needed_sse = 0;
 
-        classifier_base( func_info info,
-                         const data_layout &dl )
-            : info( std::move( info ) ), dl( dl )
+        classifier_base( func_info info, const type_layouts< data_layout > &layouts )
+            : info( std::move( info ) ), layouts( layouts )
         {}
 
         auto size( mlir::Type t )
         {
-            return dl.getTypeSizeInBits( t );
+            return layouts.size( t );
         }
 
         auto align( type )
@@ -409,7 +410,7 @@ namespace vast::abi
         }
 
         // TODO(abi): Refactor.
-        auto mk_ctx() const { return std::make_tuple( dl, info.raw_fn ); }
+        const auto &mk_ctx() const { return layouts; }
 
         classification_t get_aggregate_class( mlir::Type t, std::size_t &offset )
         {
@@ -417,14 +418,13 @@ namespace vast::abi
                 return { Class::Memory, {} };
             // TODO(abi): C++ perks.
 
-            auto fields = TypeConfig::fields( t, info.raw_fn );
             classification_t result = { Class::NoClass, Class::NoClass };
 
             auto field_offset = offset;
-            for ( auto field_type : fields )
+            for ( const auto &field : layouts.layout( t ).fields )
             {
-                auto field_class = classify( field_type, field_offset );
-                field_offset += size( field_type );
+                auto field_class = classify( field.type, field_offset );
+                field_offset += field.size;
                 result = join( result, field_class );
             }
 
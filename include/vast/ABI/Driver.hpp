@@ -8,20 +8,60 @@ VAST_RELAX_WARNINGS
 #include <mlir/IR/MLIRContext.h>
 #include <mlir/IR/Value.h>
 #include <mlir/IR/BuiltinOps.h>
+#include <llvm/ADT/DenseMap.h>
 VAST_UNRELAX_WARNINGS
 
 #include "vast/Dialect/HighLevel/HighLevelTypes.hpp"
+#include "vast/Dialect/HighLevel/RecordIndex.hpp"
 
 #include "vast/ABI/Classify.hpp"
 #include "vast/ABI/ABI.hpp"
+#include "vast/ABI/Layout.hpp"
+
+#include <memory>
 
 namespace vast::abi
 {
     template< typename FnOp >
-    auto make_x86_64( FnOp fn, const mlir::DataLayout &dl )
+    auto make_x86_64( FnOp fn, const type_layouts< mlir::DataLayout > &layouts )
     {
         using out = func_info< FnOp >;
         using classifier = classifier_base< out, mlir::DataLayout >;
-        return make< FnOp, classifier >( fn, dl );
+        return make< FnOp, classifier >( fn, layouts );
     }
+
+    template< typename FnOp >
+    auto make_x86_64( FnOp fn, const mlir::DataLayout &dl, const hl::record_index &records )
+    {
+        return make_x86_64( fn, type_layouts< mlir::DataLayout >( dl, records ) );
+    }
+
+    // Classification depends only on the function type, given the data layout
+    // and records the cache was created with. Results are memoized per type
+    // and stay at a stable address for the lifetime of the cache.
+    template< typename FnOp >
+    struct x86_64_cache
+    {
+        using info_t = func_info< FnOp >;
+
+        x86_64_cache( const mlir::DataLayout &dl, const hl::record_index &records )
+            : layouts( dl, records )
+        {}
+
+        const info_t &get( FnOp fn )
+        {
+            mlir_type type = fn.getFunctionType();
+            if ( auto it = infos.find( type ); it != infos.end() )
+                return *it->second;
+
+            auto info = std::make_unique< info_t >( make_x86_64( fn, layouts ) );
+            return *infos.try_emplace( type, std::move( info ) ).first->second;
+        }
+
+        std::size_t size() const { return infos.size(); }
+
+      private:
+        type_layouts< mlir::DataLayout > layouts;
+        llvm::DenseMap< mlir_type, std::unique_ptr< info_t > > infos;
+    };
 } // namespace vast::abi
@@ -0,0 +1,94 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#pragma once
+
+#include "vast/Util/Warnings.hpp"
+
+VAST_RELAX_WARNINGS
+#include <llvm/ADT/DenseMap.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Dialect/HighLevel/HighLevelUtils.hpp"
+#include "vast/Dialect/HighLevel/RecordIndex.hpp"
+
+#include "vast/Util/Common.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace vast::abi
+{
+    // Summary of a record as seen by the classification, fields are laid out
+    // one after another without padding.
+    struct record_layout
+    {
+        struct field_t
+        {
+            mlir_type type;
+            // In bits.
+            std::size_t offset;
+            std::size_t size;
+
+            std::size_t end() const { return offset + size; }
+        };
+
+        std::vector< field_t > fields;
+
+        // First field that ends after `offset`, null if there is none.
+        const field_t *field_containing( std::size_t offset ) const
+        {
+            auto it = std::upper_bound( fields.begin(), fields.end(), offset,
+                                        []( std::size_t off, const field_t &f )
+                                        {
+                                            return off < f.end();
+                                        } );
+            return it != fields.end() ? &*it : nullptr;
+        }
+    };
+
+    // Memoized sizes of types and layouts of records, shared by all
+    // classifications against the same data layout and records.
+    template< typename DL >
+    struct type_layouts
+    {
+        const DL &dl;
+        const hl::record_index &records;
+
+        type_layouts( const DL &dl, const hl::record_index &records )
+            : dl( dl ), records( records )
+        {}
+
+        std::size_t size( mlir_type t ) const
+        {
+            if ( auto it = sizes.find( t ); it != sizes.end() )
+                return it->second;
+            std::size_t bits = dl.getTypeSizeInBits( t );
+            sizes.try_emplace( t, bits );
+            return bits;
+        }
+
+        const record_layout &layout( mlir_type t ) const
+        {
+            if ( auto it = layouts.find( t ); it != layouts.end() )
+                return *it->second;
+
+            auto out = std::make_unique< record_layout >();
+            std::size_t offset = 0;
+            for ( auto field : hl::field_types( t, records ) )
+            {
+                auto bits = size( field );
+                out->fields.push_back( { field, offset, bits } );
+                offset += bits;
+            }
+            return *layouts.try_emplace( t, std::move( out ) ).first->second;
+        }
+
+      private:
+        mutable llvm::DenseMap< mlir_type, std::size_t > sizes;
+        // Boxed, so that references survive growth of the map while nested
+        // records are being laid out.
+        mutable llvm::DenseMap< mlir_type, std::unique_ptr< record_layout > > layouts;
+    };
+
+} // namespace vast::abi
@@ -66,9 +66,7 @@ namespace vast::cg
         codegen_instance(codegen_context &cgctx, meta_generator &meta)
             : base(cgctx, meta)
         {
-            mlir::registerAllDialects(cgctx.mctx);
-            vast::registerAllDialects(cgctx.mctx);
-            cgctx.mctx.loadAllAvailableDialects();
+            vast::loadDefaultDialects(cgctx.mctx);
 
             scope = std::unique_ptr< scope_t >( new scope_t{
                 .typedefs   = cgctx.typedefs,
@@ -347,6 +347,10 @@ namespace vast::cg {
         mlir_value constant(loc_t loc, mlir_type ty, string_ref value) {
             return create< hl::ConstantOp >(loc, ty, value);
         }
+
+        mlir_value constant(loc_t loc, mlir_type ty, mlir::DenseElementsAttr value) {
+            return create< hl::ConstantOp >(loc, ty, value);
+        }
     };
 
 } // namespace vast::cg
@@ -10,6 +10,7 @@ VAST_RELAX_WARNINGS
 #include <clang/Basic/SourceManager.h>
 #include <llvm/ADT/ScopedHashTable.h>
 #include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/ADT/StringMap.h>
 #include <llvm/IR/GlobalValue.h>
 #include <mlir/IR/MLIRContext.h>
 #include <mlir/IR/Value.h>
@@ -74,6 +75,34 @@ namespace vast::cg
         }
     } // namespace detail
 
+    //
+    // Memoized conversions of clang types to mlir types.
+    //
+    // Keys are opaque pointers of qualified clang types. Clang uniques types,
+    // hence the key is unique per type while it still distinguishes sugar,
+    // such as typedefs or elaborated types, that is preserved in high level
+    // types.
+    //
+    struct type_cache {
+        mlir_type lookup(clang::QualType type) {
+            if (auto it = types.find(type.getAsOpaquePtr()); it != types.end()) {
+                ++hits;
+                return it->second;
+            }
+            ++misses;
+            return {};
+        }
+
+        void insert(clang::QualType type, mlir_type mty) {
+            types.try_emplace(type.getAsOpaquePtr(), mty);
+        }
+
+        llvm::DenseMap< void *, mlir_type > types;
+
+        std::size_t hits   = 0;
+        std::size_t misses = 0;
+    };
+
     struct codegen_context {
         mcontext_t &mctx;
         acontext_t &actx;
@@ -125,6 +154,8 @@ namespace vast::cg
         using LabelTable = scoped_table< const clang::LabelDecl*, hl::LabelDeclOp >;
         LabelTable labels;
 
+        type_cache types;
+
         size_t anonymous_count = 0;
         llvm::DenseMap< const clang::NamedDecl *, std::string > tag_names;
 
@@ -178,10 +209,15 @@ namespace vast::cg
             default_methods_to_emit.emplace_back(decl);
         }
 
+        // Index of module level functions and variables by their symbol names.
+        // It is filled in by `declare`, so lookups do not need to scan the
+        // module body. Code generation neither erases nor replaces module level
+        // symbols (see `codegen_driver::apply_replacements`), code that starts
+        // to do so has to update the index as well.
+        llvm::StringMap< operation > global_symbols;
+
         operation get_global_value(mangled_name_ref name) {
-            if (auto global = mlir::SymbolTable::lookupSymbolIn(mod.get(), name.name))
-                return global;
-            return {};
+            return global_symbols.lookup(name.name);
         }
 
         mlir_value get_global_value(const clang::Decl * /* decl */) {
@@ -259,15 +295,25 @@ namespace vast::cg
         }
 
         hl::FuncOp declare(mangled_name_ref mangled, auto vast_decl_builder) {
-            return declare< hl::FuncOp >(funcdecls, mangled, vast_decl_builder, mangled.name);
+            auto fn = declare< hl::FuncOp >(funcdecls, mangled, vast_decl_builder, mangled.name);
+            if (fn) {
+                global_symbols.try_emplace(mangled.name, fn);
+            }
+            return fn;
         }
 
         mlir_value declare(const clang::VarDecl *decl, mlir_value vast_value) {
-            return declare< mlir_value >(vars, decl, [vast_value] { return vast_value; }, decl->getName());
+            return declare(decl, [vast_value] { return vast_value; });
         }
 
         mlir_value declare(const clang::VarDecl *decl, auto vast_decl_builder) {
-            return declare< mlir_value >(vars, decl, vast_decl_builder, decl->getName());
+            auto var = declare< mlir_value >(vars, decl, vast_decl_builder, decl->getName());
+            if (var && decl->isFileVarDecl()) {
+                if (auto op = var.getDefiningOp< hl::VarDeclOp >()) {
+                    global_symbols.try_emplace(op.getName(), op);
+                }
+            }
+            return var;
         }
 
         hl::LabelDeclOp declare(const clang::LabelDecl *decl, auto vast_decl_builder) {
@@ -17,6 +17,9 @@ VAST_UNRELAX_WARNINGS
 #include "vast/Util/Common.hpp"
 #include "vast/Util/DataLayout.hpp"
 
+#include <functional>
+#include <vector>
+
 namespace vast::cg
 {
     struct codegen_driver;
@@ -69,6 +72,15 @@ namespace vast::cg
 
         void finalize();
 
+        // Asked for each function definition before its body is generated,
+        // the body is left empty if it returns true, e.g., because the caller
+        // provides it.
+        using definition_callback = std::function< bool(hl::FuncOp, const clang::FunctionDecl *) >;
+
+        void on_function_definition(definition_callback callback) {
+            skip_body = std::move(callback);
+        }
+
         const acontext_t &acontext() const { return cgctx.actx; }
         const mcontext_t &mcontext() const { return cgctx.mctx; }
 
@@ -129,6 +141,8 @@ namespace vast::cg
         friend struct defer_handle_of_top_level_decl;
         llvm::SmallVector< clang::FunctionDecl *, 8 > deferred_inline_member_func_defs;
 
+        definition_callback skip_body;
+
         meta_generator_ptr meta;
         default_codegen codegen;
     };
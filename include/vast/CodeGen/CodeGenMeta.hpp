@@ -9,6 +9,8 @@ VAST_RELAX_WARNINGS
 #include <clang/AST/CXXInheritance.h>
 #include <clang/AST/TypeLoc.h>
 #include <clang/Basic/FileEntry.h>
+#include <clang/Basic/SourceManager.h>
+#include <llvm/ADT/DenseMap.h>
 VAST_UNRELAX_WARNINGS
 
 #include "vast/Dialect/Meta/MetaAttributes.hpp"
@@ -26,38 +28,74 @@ namespace vast::cg
 
     using meta_generator_ptr = std::unique_ptr< meta_generator >;
 
+    //
+    // Converts clang source locations to file locations. Names of files are
+    // uniqued once per file and locations once per source location, as clang
+    // hands out the same location to many nodes, e.g., to an expression and
+    // its implicit casts. Lines and columns are looked up from decomposed
+    // offsets in line tables that the source manager caches per file.
+    //
+    struct file_location_cache {
+        file_location_cache(const clang::SourceManager &sm, mcontext_t *mctx)
+            : sm(sm), mctx(mctx)
+        {}
+
+        loc_t get(clang::SourceLocation loc) {
+            auto [it, inserted] = locations.try_emplace(loc.getRawEncoding());
+            if (inserted) {
+                it->second = make(loc);
+            }
+            return it->second;
+        }
+
+      private:
+
+        // As `clang::FullSourceLoc`, the file, the line and the column are
+        // looked up in the file id the location is in. Locations in macro
+        // expansions and invalid locations are not in a file, hence they map
+        // to line 1, column 1 of an unknown file.
+        mlir::FileLineColLoc make(clang::SourceLocation loc) {
+            auto [fid, offset] = sm.getDecomposedLoc(loc);
+            return mlir::FileLineColLoc::get(
+                file_name(fid), sm.getLineNumber(fid, offset), sm.getColumnNumber(fid, offset)
+            );
+        }
+
+        mlir::StringAttr file_name(clang::FileID fid) {
+            auto [it, inserted] = files.try_emplace(fid);
+            if (inserted) {
+                auto entry = fid.isValid() ? sm.getFileEntryForID(fid) : nullptr;
+                it->second = mlir::StringAttr::get(mctx, entry ? entry->getName() : "unknown");
+            }
+            return it->second;
+        }
+
+        const clang::SourceManager &sm;
+        mcontext_t *mctx;
+
+        llvm::DenseMap< clang::FileID, mlir::StringAttr > files;
+        llvm::DenseMap< clang::SourceLocation::UIntTy, mlir::LocationAttr > locations;
+    };
+
     struct default_meta_gen : meta_generator {
         default_meta_gen(acontext_t *actx, mcontext_t *mctx)
-            : actx(actx), mctx(mctx)
+            : cache(actx->getSourceManager(), mctx)
         {}
 
         loc_t location(const clang::Decl *decl) const final {
-            return location(decl->getLocation());
+            return cache.get(decl->getLocation());
         }
 
         loc_t location(const clang::Stmt *stmt) const final {
-            return location(stmt->getBeginLoc());
+            return cache.get(stmt->getBeginLoc());
         }
 
         loc_t location(const clang::Expr *expr) const final {
-            return location(expr->getExprLoc());
+            return cache.get(expr->getExprLoc());
         }
 
       private:
-
-        loc_t location(const clang::FullSourceLoc &loc) const {
-            auto file = loc.getFileEntry() ? loc.getFileEntry()->getName() : "unknown";
-            auto line = loc.getLineNumber();
-            auto col  = loc.getColumnNumber();
-            return { mlir::FileLineColLoc::get(mctx, file, line, col) };
-        }
-
-        loc_t location(const clang::SourceLocation &loc) const {
-            return location(clang::FullSourceLoc(loc, actx->getSourceManager()));
-        }
-
-        acontext_t *actx;
-        mcontext_t *mctx;
+        mutable file_location_cache cache;
     };
 
     struct id_meta_gen : meta_generator {
@@ -87,4 +125,45 @@ namespace vast::cg
         mcontext_t *mctx;
     };
 
+    static inline mlir::TypeID lazy_location_id() {
+        return mlir::TypeID::get< clang::SourceLocation >();
+    }
+
+    //
+    // Keeps raw encodings of clang source locations in opaque locations, so
+    // that codegen does not look up files, lines and columns at all. Opaque
+    // locations print as unknown locations until they are expanded by
+    // `expand_lazy_locations`, e.g., only if they are going to be printed or
+    // lowered.
+    //
+    struct lazy_meta_gen : meta_generator {
+        lazy_meta_gen(acontext_t *, mcontext_t *mctx)
+            : unknown(mlir::UnknownLoc::get(mctx))
+        {}
+
+        loc_t location(const clang::Decl *decl) const final {
+            return make_location(decl->getLocation());
+        }
+
+        loc_t location(const clang::Stmt *stmt) const final {
+            return make_location(stmt->getBeginLoc());
+        }
+
+        loc_t location(const clang::Expr *expr) const final {
+            return make_location(expr->getExprLoc());
+        }
+
+      private:
+
+        loc_t make_location(clang::SourceLocation loc) const {
+            return mlir::OpaqueLoc::get(loc.getRawEncoding(), lazy_location_id(), unknown);
+        }
+
+        loc_t unknown;
+    };
+
+    // Replaces opaque locations made by `lazy_meta_gen` in `root` by file
+    // locations.
+    void expand_lazy_locations(operation root, const clang::SourceManager &sm);
+
 } // namespace vast::cg
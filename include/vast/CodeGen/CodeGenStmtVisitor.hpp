@@ -7,6 +7,8 @@
 VAST_RELAX_WARNINGS
 #include <clang/AST/StmtVisitor.h>
 #include <clang/AST/OperationKinds.h>
+#include <mlir/IR/BuiltinAttributes.h>
+#include <mlir/IR/BuiltinTypes.h>
 VAST_UNRELAX_WARNINGS
 
 #include "vast/CodeGen/CodeGenMeta.hpp"
@@ -41,6 +43,7 @@ namespace vast::cg {
         using lens::derived;
         using lens::context;
         using lens::mcontext;
+        using lens::acontext;
 
         using lens::visit;
         using lens::visit_as_lvalue_type;
@@ -975,10 +978,26 @@ namespace vast::cg {
             return make< hl::CallOp >(meta_location(expr), callee, args);
         }
 
+        core::FunctionType callee_function_type(clang::QualType callee) {
+            if (auto ptr = callee->getAs< clang::PointerType >()) {
+                callee = ptr->getPointeeType();
+            }
+
+            if (auto fty = callee->getAs< clang::FunctionType >()) {
+                return mlir::dyn_cast_or_null< core::FunctionType >(
+                    visit(clang::QualType(fty, 0))
+                );
+            }
+
+            return {};
+        }
+
         operation VisitIndirectCall(const clang::CallExpr *expr) {
             auto callee = VisitIndirectCallee(expr->getCallee())->getResult(0);
             auto args   = VisitArguments(expr);
-            auto type   = hl::getFunctionType(callee.getType(), context().mod.get());
+            // The callee type is resolved from clang, looking through typedefs
+            // of the generated module would walk it at every call site.
+            auto type   = callee_function_type(expr->getCallee()->getType());
             if (type) {
                 return make< hl::IndirectCallOp >(
                     meta_location(expr), type.getResults(), callee, args
@@ -1098,9 +1117,109 @@ namespace vast::cg {
         // operation VisitCompoundLiteralExpr(const clang::CompoundLiteralExpr *lit)
         // operation VisitFixedPointLiteral(const clang::FixedPointLiteral *lit)
 
+        // Arrays of at least this many scalars are initialized by a single
+        // dense constant if clang can evaluate the initializer.
+        static constexpr std::uint64_t dense_initializer_threshold = 16;
+
+        // Builtin type of elements of a dense constant of `type` elements.
+        mlir_type dense_element_type(clang::QualType type) {
+            auto &actx = acontext();
+            if (type->isIntegerType() && !type->isBooleanType() && !type->isBitIntType()) {
+                auto width = actx.getIntWidth(type);
+                if (width == 8 || width == 16 || width == 32 || width == 64) {
+                    return mlir::IntegerType::get(&mcontext(), unsigned(width));
+                }
+                return {};
+            }
+
+            if (type->isRealFloatingType()) {
+                const auto &semantics = actx.getFloatTypeSemantics(type);
+                if (&semantics == &llvm::APFloat::IEEEsingle()) {
+                    return mlir::Float32Type::get(&mcontext());
+                }
+                if (&semantics == &llvm::APFloat::IEEEdouble()) {
+                    return mlir::Float64Type::get(&mcontext());
+                }
+            }
+
+            return {};
+        }
+
+        // Initializes a large array of scalars by a single constant instead of
+        // an operation per element, e.g., a lookup table. Null if the
+        // initializer is not a constant that can be represented densely.
+        operation dense_initializer(const clang::InitListExpr *expr, mlir_type ty) {
+            if (expr->isStringLiteralInit()) {
+                return {};
+            }
+
+            auto &actx = acontext();
+            auto array = actx.getAsConstantArrayType(expr->getType());
+            if (!array || array->getSize().ult(dense_initializer_threshold)) {
+                return {};
+            }
+
+            auto element = actx.getCanonicalType(array->getElementType());
+            auto element_type = dense_element_type(element);
+            if (!element_type) {
+                return {};
+            }
+
+            clang::Expr::EvalResult result;
+            if (!expr->EvaluateAsRValue(result, actx) || result.HasSideEffects) {
+                return {};
+            }
+
+            const auto &value = result.Val;
+            if (!value.isArray()) {
+                return {};
+            }
+
+            auto size = array->getSize().getZExtValue();
+            auto element_at = [&] (std::uint64_t idx) -> const clang::APValue * {
+                if (idx < value.getArrayInitializedElts()) {
+                    return &value.getArrayInitializedElt(unsigned(idx));
+                }
+                return value.hasArrayFiller() ? &value.getArrayFiller() : nullptr;
+            };
+
+            auto tensor = mlir::RankedTensorType::get({ std::int64_t(size) }, element_type);
+
+            mlir::DenseElementsAttr elements;
+            if (element->isIntegerType()) {
+                std::vector< ap_int > values;
+                values.reserve(size);
+                for (std::uint64_t idx = 0; idx < size; ++idx) {
+                    auto elem = element_at(idx);
+                    if (!elem || !elem->isInt()) {
+                        return {};
+                    }
+                    values.push_back(elem->getInt());
+                }
+                elements = mlir::DenseElementsAttr::get(tensor, values);
+            } else {
+                std::vector< ap_float > values;
+                values.reserve(size);
+                for (std::uint64_t idx = 0; idx < size; ++idx) {
+                    auto elem = element_at(idx);
+                    if (!elem || !elem->isFloat()) {
+                        return {};
+                    }
+                    values.push_back(elem->getFloat());
+                }
+                elements = mlir::DenseElementsAttr::get(tensor, values);
+            }
+
+            return constant(meta_location(expr), ty, elements).getDefiningOp();
+        }
+
         operation VisitInitListExpr(const clang::InitListExpr *expr) {
             auto ty = visit(expr->getType());
 
+            if (auto dense = dense_initializer(expr, ty)) {
+                return dense;
+            }
+
             llvm::SmallVector< Value > elements;
             for (auto elem : expr->inits()) {
                 elements.push_back(visit(elem)->getResult(0));
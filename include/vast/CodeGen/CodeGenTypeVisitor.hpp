@@ -171,7 +171,28 @@ namespace vast::cg {
             return with_cvr_qualifiers(type_builder< hl::PointerType >().bind(pointee), quals).freeze();
         }
 
+        // Visitor configurations can opt out of the memoization of types by
+        // shadowing this member.
+        static constexpr bool memoize_types = true;
+
         auto Visit(clang::QualType ty) -> mlir_type {
+            if constexpr (derived_t::memoize_types) {
+                auto &cache = context().types;
+                if (auto cached = cache.lookup(ty)) {
+                    return cached;
+                }
+
+                auto result = visit_uncached(ty);
+                if (result) {
+                    cache.insert(ty, result);
+                }
+                return result;
+            } else {
+                return visit_uncached(ty);
+            }
+        }
+
+        auto visit_uncached(clang::QualType ty) -> mlir_type {
             auto underlying = ty.getTypePtr();
             auto quals      = ty.getLocalQualifiers();
             if (auto t = llvm::dyn_cast< clang::BuiltinType >(underlying)) {
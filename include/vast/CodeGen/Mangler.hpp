@@ -74,6 +74,10 @@ namespace vast::cg
 
         std::optional< clang::GlobalDecl >  lookup_representative_decl(mangled_name_ref name) const;
 
+        // Statistics of the mangled names memoization.
+        std::size_t hits   = 0;
+        std::size_t misses = 0;
+
       private:
         std::string mangle(
             clang::GlobalDecl decl, const std::string &module_name_hash
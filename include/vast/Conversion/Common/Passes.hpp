@@ -5,12 +5,16 @@
 #include "vast/Util/Warnings.hpp"
 
 VAST_RELAX_WARNINGS
+#include "mlir/Rewrite/FrozenRewritePatternSet.h"
 #include "mlir/Transforms/DialectConversion.h"
 VAST_UNRELAX_WARNINGS
 
+#include <memory>
+
 #include "vast/Conversion/TypeConverters/LLVMTypeConverter.hpp"
 #include "vast/Conversion/Common/Types.hpp"
 #include "vast/Conversion/Common/Patterns.hpp"
+#include "vast/Conversion/Common/ProfiledPattern.hpp"
 
 namespace vast {
 
@@ -19,6 +23,8 @@ namespace vast {
     //  - applying the conversion.
     //  Since we cannot easily do `using config_t = self_t::config_t` the type is instead
     //  taken as a template.
+    //  Patterns populated while a `pattern_profile` is active are wrapped to
+    //  report their match attempts.
     template< typename self_t >
     struct populate_patterns
     {
@@ -28,8 +34,13 @@ namespace vast {
             if constexpr ( list::empty ) {
                 return;
             } else {
-                self_t::template add_pattern< typename list::head >(config);
-                self_t::template legalize< typename list::head >(config);
+                using pattern = typename list::head;
+                if (pattern_profile::active()) {
+                    self_t::template add_pattern< profiled_pattern< pattern > >(config);
+                } else {
+                    self_t::template add_pattern< pattern >(config);
+                }
+                self_t::template legalize< pattern >(config);
                 return self_t::template populate_conversions_impl<typename list::tail>(config);
             }
         }
@@ -52,6 +63,13 @@ namespace vast {
                                                 std::move(config.patterns));
         }
 
+        // Applies patterns frozen once for all runs of the pass.
+        auto apply_conversions(
+            const conversion_target &target, const mlir::FrozenRewritePatternSet &patterns
+        ) {
+            return mlir::applyPartialConversion(self().getOperation(), target, patterns);
+        }
+
         template< typename ...lists, typename config_t  >
         static void populate_conversions_base(config_t &config) {
             (self_t::template populate_conversions_impl< lists >(config), ...);
@@ -76,6 +94,10 @@ namespace vast {
     // Aside from populating collection of patterns, this method also calls `legalize` method
     // of every pattern being added.
     //
+    // Both are called once in `initialize`, the frozen patterns and the target are
+    // then shared by all runs of the pass and all its clones. Patterns must not keep
+    // state of a single run, use `run_bound` for analyses of the converted module.
+    //
     // Example usage:
     //
     // struct ExamplePass : ModuleConversionPassMixin< ExamplePass, ExamplePassBase > {
@@ -126,14 +148,19 @@ namespace vast {
         // Override
         void populate_conversions(config_t &){}
 
-        void run_on_operation() {
-            auto &ctx   = getContext();
-            auto config = config_t { rewrite_pattern_set(&ctx),
-                                     derived_t::create_conversion_target(ctx) };
+        logical_result initialize(mcontext_t *ctx) override {
+            auto config = config_t { rewrite_pattern_set(ctx),
+                                     derived_t::create_conversion_target(*ctx) };
 
             self().populate_conversions(config);
 
-            if (failed(populate::apply_conversions(std::move(config))))
+            frozen_target   = std::make_shared< const conversion_target >(std::move(config.target));
+            frozen_patterns = mlir::FrozenRewritePatternSet(std::move(config.patterns));
+            return mlir::success();
+        }
+
+        void run_on_operation() {
+            if (failed(populate::apply_conversions(*frozen_target, frozen_patterns)))
                 return signalPassFailure();
 
             this->after_operation();
@@ -145,6 +172,11 @@ namespace vast {
         // Override to specify what is supposed to run after `run_on_operation` is finished.
         // This will run *only if the `run_on_operation* was successful.
         virtual void after_operation() {};
+
+        // Copies of the pass share the frozen state, it is never modified after
+        // `initialize`.
+        std::shared_ptr< const conversion_target > frozen_target;
+        mlir::FrozenRewritePatternSet frozen_patterns;
     };
 
     // Sibling of the above module for passes that go to the LLVM dialect.
@@ -169,6 +201,10 @@ namespace vast {
     //     }
     // }
     //
+    // The type converter, patterns and target are built once in `initialize`. The
+    // record index and the data layout analysis of the converted module are bound
+    // to the type converter for the duration of a run.
+    //
     template< typename derived_t, template< typename > typename base_t >
     struct ModuleLLVMConversionPassMixin
         : base_t< derived_t >
@@ -216,25 +252,38 @@ namespace vast {
             cfg.patterns.template add< pattern >(cfg.tc);
         }
 
-        void run_on_operation() {
-            auto &ctx   = getContext();
-            const auto &dl_analysis = this->template getAnalysis< mlir::DataLayoutAnalysis >();
-
-            mlir::LowerToLLVMOptions llvm_options{ &ctx };
+        logical_result initialize(mcontext_t *ctx) override {
+            mlir::LowerToLLVMOptions llvm_options{ ctx };
             derived_t::set_llvm_opts(llvm_options);
 
-            auto tc = llvm_type_converter(getOperation(), &ctx, llvm_options, &dl_analysis);
+            // Patterns and the target keep a reference to the converter.
+            tc = std::make_shared< llvm_type_converter >(ctx, llvm_options);
             auto cfg = config(
-                rewrite_pattern_set(&ctx), derived_t::create_conversion_target(ctx, tc), tc
+                rewrite_pattern_set(ctx), derived_t::create_conversion_target(*ctx, *tc), *tc
             );
 
             // populate all patterns
             self().populate_conversions(cfg);
 
-            if (failed(populate::apply_conversions(std::move(cfg))))
+            frozen_target   = std::make_shared< const conversion_target >(std::move(cfg.target));
+            frozen_patterns = mlir::FrozenRewritePatternSet(std::move(cfg.patterns));
+            return mlir::success();
+        }
+
+        void run_on_operation() {
+            const auto &dl_analysis = this->template getAnalysis< mlir::DataLayoutAnalysis >();
+            const auto &records     = this->template getAnalysis< hl::record_index >();
+
+            auto bound = tc->bind(records, dl_analysis);
+
+            if (failed(populate::apply_conversions(*frozen_target, frozen_patterns)))
                 return signalPassFailure();
         }
 
         void runOnOperation() override { run_on_operation(); }
+
+        std::shared_ptr< llvm_type_converter > tc;
+        std::shared_ptr< const conversion_target > frozen_target;
+        mlir::FrozenRewritePatternSet frozen_patterns;
     };
 }
@@ -0,0 +1,139 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#pragma once
+
+#include "vast/Util/Warnings.hpp"
+
+VAST_RELAX_WARNINGS
+#include <llvm/Support/TypeName.h>
+#include <mlir/Conversion/LLVMCommon/Pattern.h>
+#include <mlir/IR/PatternMatch.h>
+#include <mlir/Transforms/DialectConversion.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Conversion/Common/Types.hpp"
+#include "vast/Util/Common.hpp"
+#include "vast/Util/PatternProfile.hpp"
+
+#include <concepts>
+
+namespace vast {
+
+    namespace detail {
+
+        template< typename op_t >
+        op_t conversion_source_op(const mlir::OpConversionPattern< op_t > *);
+
+        template< typename op_t >
+        op_t conversion_source_op(const mlir::ConvertOpToLLVMPattern< op_t > *);
+
+        template< typename op_t >
+        op_t rewrite_source_op(const mlir::OpRewritePattern< op_t > *);
+
+        template< typename pattern_t >
+        concept op_conversion_pattern = requires (const pattern_t *pattern) {
+            conversion_source_op(pattern);
+        };
+
+        template< typename pattern_t >
+        concept op_rewrite_pattern = requires (const pattern_t *pattern) {
+            rewrite_source_op(pattern);
+        };
+
+        template< typename pattern_t >
+        concept any_op_conversion_pattern = !op_conversion_pattern< pattern_t >
+            && std::derived_from< pattern_t, mlir::ConversionPattern >;
+
+        // Reports a single match attempt of `pattern_t` on `op` to the active
+        // profile, if there is any.
+        template< typename pattern_t >
+        logical_result profile(operation op, auto &&match_and_rewrite) {
+            auto profile = pattern_profile::active();
+            if (!profile) {
+                return match_and_rewrite();
+            }
+
+            auto start  = pattern_profile::clock::now();
+            auto result = match_and_rewrite();
+            profile->add(
+                llvm::getTypeName< pattern_t >(),
+                op->getName().getStringRef(),
+                mlir::succeeded(result),
+                pattern_profile::clock::now() - start
+            );
+            return result;
+        }
+
+    } // namespace detail
+
+    //
+    // Wrappers of patterns that report their match attempts. A wrapper
+    // overrides the most specific `matchAndRewrite` its pattern kind allows,
+    // hence it also measures patterns that implement `match` and `rewrite`.
+    //
+    template< typename pattern_t >
+    struct profiled_op_conversion : pattern_t
+    {
+        using pattern_t::pattern_t;
+
+        using op_t      = decltype(detail::conversion_source_op(std::declval< const pattern_t * >()));
+        using adaptor_t = typename pattern_t::OpAdaptor;
+
+        logical_result matchAndRewrite(
+            op_t op, adaptor_t adaptor, conversion_rewriter &rewriter
+        ) const override {
+            return detail::profile< pattern_t >(op, [&] {
+                return pattern_t::matchAndRewrite(op, adaptor, rewriter);
+            });
+        }
+    };
+
+    template< typename pattern_t >
+    struct profiled_any_op_conversion : pattern_t
+    {
+        using pattern_t::pattern_t;
+
+        logical_result matchAndRewrite(
+            operation op, llvm::ArrayRef< mlir_value > operands, conversion_rewriter &rewriter
+        ) const override {
+            return detail::profile< pattern_t >(op, [&] {
+                return pattern_t::matchAndRewrite(op, operands, rewriter);
+            });
+        }
+    };
+
+    template< typename pattern_t >
+    struct profiled_op_rewrite : pattern_t
+    {
+        using pattern_t::pattern_t;
+
+        using op_t = decltype(detail::rewrite_source_op(std::declval< const pattern_t * >()));
+
+        logical_result matchAndRewrite(op_t op, pattern_rewriter &rewriter) const override {
+            return detail::profile< pattern_t >(op, [&] {
+                return pattern_t::matchAndRewrite(op, rewriter);
+            });
+        }
+    };
+
+    namespace detail {
+
+        // Patterns of other kinds are left as they are.
+        template< typename pattern_t >
+        struct profiled { using type = pattern_t; };
+
+        template< op_conversion_pattern pattern_t >
+        struct profiled< pattern_t > { using type = profiled_op_conversion< pattern_t >; };
+
+        template< any_op_conversion_pattern pattern_t >
+        struct profiled< pattern_t > { using type = profiled_any_op_conversion< pattern_t >; };
+
+        template< op_rewrite_pattern pattern_t >
+        struct profiled< pattern_t > { using type = profiled_op_rewrite< pattern_t >; };
+
+    } // namespace detail
+
+    template< typename pattern_t >
+    using profiled_pattern = typename detail::profiled< pattern_t >::type;
+
+} // namespace vast
@@ -0,0 +1,65 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#pragma once
+
+#include "vast/Util/Warnings.hpp"
+
+namespace vast {
+
+    //
+    // Per-run state of patterns that are built once in `Pass::initialize`.
+    //
+    // Frozen patterns are shared by all runs and all threads of a pass, so
+    // they cannot keep references to analyses of a single module. Instead
+    // they keep a `run_bound` slot and a run binds the value for its thread
+    // for as long as the returned scope lives.
+    //
+    // Example usage:
+    //
+    // struct pattern : mlir::OpConversionPattern< op_t > {
+    //     run_bound< hl::record_index > records;
+    //     ... records.get().lookup(type) ...
+    // };
+    //
+    // void runOnOperation() override {
+    //     auto bound = run_bound< hl::record_index >::bind(getAnalysis< hl::record_index >());
+    //     mlir::applyPartialConversion(getOperation(), *target, frozen_patterns);
+    // }
+    //
+    template< typename value_t >
+    struct run_bound
+    {
+        struct [[nodiscard]] scope
+        {
+            explicit scope(const value_t &value) : previous(current()) {
+                current() = &value;
+            }
+
+            ~scope() { current() = previous; }
+
+            scope(const scope &) = delete;
+            scope &operator=(const scope &) = delete;
+
+          private:
+            const value_t *previous;
+        };
+
+        static scope bind(const value_t &value) { return scope(value); }
+
+        static bool is_bound() { return current() != nullptr; }
+
+        const value_t &get() const {
+            VAST_CHECK(is_bound(), "run state is not bound on this thread");
+            return *current();
+        }
+
+        const value_t *operator->() const { return &get(); }
+
+      private:
+        static const value_t *&current() {
+            static thread_local const value_t *value = nullptr;
+            return value;
+        }
+    };
+
+} // namespace vast
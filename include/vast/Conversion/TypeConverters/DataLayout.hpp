@@ -16,6 +16,8 @@ VAST_RELAX_WARNINGS
 #include <mlir/Interfaces/DataLayoutInterfaces.h>
 VAST_UNRELAX_WARNINGS
 
+#include "vast/Dialect/Core/CoreAttributes.hpp"
+
 #include "vast/Util/Common.hpp"
 #include "vast/Util/DataLayout.hpp"
 
@@ -54,7 +56,9 @@ namespace vast::conv::tc {
                 flattened.push_back(wrapped);
             }
 
-            return mlir::DataLayoutSpecAttr::get(&mctx, flattened);
+            return core::DataLayoutTableAttr::get(
+                &mctx, mlir::DataLayoutSpecAttr::get(&mctx, flattened)
+            );
         }
 
         llvm::DenseMap< mlir_type, mlir_attr > entries;
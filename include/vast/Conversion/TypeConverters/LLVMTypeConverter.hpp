@@ -13,8 +13,10 @@ VAST_UNRELAX_WARNINGS
 
 #include "vast/Dialect/HighLevel/HighLevelTypes.hpp"
 #include "vast/Dialect/HighLevel/HighLevelUtils.hpp"
+#include "vast/Dialect/HighLevel/RecordIndex.hpp"
 #include "vast/Util/Maybe.hpp"
 
+#include "vast/Conversion/Common/RunBound.hpp"
 #include "vast/Conversion/TypeConverters/TypeConverter.hpp"
 
 // TODO(lukas): Possibly move this out of Util?
@@ -56,6 +58,32 @@ namespace vast::conv::tc {
         LLVMTypeConverter &operator=(const LLVMTypeConverter &) = delete;
         LLVMTypeConverter &operator=(LLVMTypeConverter &&)      = delete;
 
+        // Converters built once in `Pass::initialize` are reused by the runs
+        // of the pass. A run sets the data layout analysis of its module to
+        // the base converter for as long as the returned scope lives, so that
+        // `getDataLayoutAnalysis` is up to date for MLIR patterns as well.
+        struct [[nodiscard]] data_layout_scope
+        {
+            data_layout_scope(LLVMTypeConverter &tc, const mlir::DataLayoutAnalysis &dl)
+                : tc(tc), previous(tc.dataLayoutAnalysis)
+            {
+                tc.dataLayoutAnalysis = &dl;
+            }
+
+            ~data_layout_scope() { tc.dataLayoutAnalysis = previous; }
+
+            data_layout_scope(const data_layout_scope &) = delete;
+            data_layout_scope &operator=(const data_layout_scope &) = delete;
+
+          private:
+            LLVMTypeConverter &tc;
+            const mlir::DataLayoutAnalysis *previous;
+        };
+
+        data_layout_scope bind_data_layout(const mlir::DataLayoutAnalysis &dl) {
+            return { *this, dl };
+        }
+
         maybe_types_t do_conversion(mlir::Type t) {
             types_t out;
             if (mlir::succeeded(this->convertTypes(t, out))) {
@@ -293,26 +321,41 @@ namespace vast::conv::tc {
 
     // Requires that the named types *always* map to llvm struct types.
     // TODO(lukas): What about type aliases.
+    //
+    // The converter is reused by the runs of a pass, its record index and data
+    // layout analysis are bound by the running pass (see `bind`).
     struct FullLLVMTypeConverter
         : LLVMTypeConverter
         , LLVMStruct< FullLLVMTypeConverter >
     {
         using base = LLVMTypeConverter;
 
-        vast_module mod;
+        run_bound< hl::record_index > records;
 
         template< typename... Args >
-        FullLLVMTypeConverter(vast_module mod, Args &&...args)
-            : base(std::forward< Args >(args)...), mod(mod)
+        FullLLVMTypeConverter(Args &&...args)
+            : base(std::forward< Args >(args)...)
         {
             addConversion(convert_recordlike< hl::RecordType >());
         }
 
+        struct [[nodiscard]] bound_scope
+        {
+            run_bound< hl::record_index >::scope records;
+            data_layout_scope data_layout;
+        };
+
+        bound_scope bind(
+            const hl::record_index &records, const mlir::DataLayoutAnalysis &dl_analysis
+        ) {
+            return { run_bound< hl::record_index >::bind(records), bind_data_layout(dl_analysis) };
+        }
+
         auto get_field_types(mlir_type t) -> std::optional< gap::generator< mlir_type > > {
             if (!mlir::isa< hl::RecordType >(t)) {
                 return {};
             }
-            auto def = hl::definition_of(t, mod);
+            auto def = hl::definition_of(t, records.get());
             // Nothing found, leave the structure opaque.
             if (!def) {
                 return {};
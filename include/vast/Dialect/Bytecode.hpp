@@ -0,0 +1,71 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#pragma once
+
+#include "vast/Util/Warnings.hpp"
+
+VAST_RELAX_WARNINGS
+#include <mlir/Bytecode/BytecodeImplementation.h>
+#include <mlir/IR/Dialect.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Util/Common.hpp"
+
+#include <cstdint>
+#include <memory>
+
+namespace vast {
+
+    struct dialect_version : mlir::DialectVersion
+    {
+        explicit dialect_version(std::uint64_t value) : value(value) {}
+
+        std::uint64_t value;
+    };
+
+    //
+    // Bytecode interface that stores the version of a dialect in MLIR
+    // bytecode.
+    //
+    // Attributes and types keep their textual encoding in bytecode, hence
+    // a dump stays readable as long as its version is not newer than the
+    // `current_version` of the reading dialect. Bumping the version lets
+    // `upgradeFromVersion` rewrite dumps produced by older releases.
+    //
+    template< std::uint64_t current_version >
+    struct versioned_bytecode_interface : mlir::BytecodeDialectInterface
+    {
+        using mlir::BytecodeDialectInterface::BytecodeDialectInterface;
+
+        static constexpr std::uint64_t version = current_version;
+
+        void writeVersion(mlir::DialectBytecodeWriter &writer) const override {
+            writer.writeVarInt(version);
+        }
+
+        std::unique_ptr< mlir::DialectVersion >
+        readVersion(mlir::DialectBytecodeReader &reader) const override {
+            std::uint64_t value = 0;
+            if (mlir::failed(reader.readVarInt(value))) {
+                return nullptr;
+            }
+
+            if (value > version) {
+                reader.emitError() << "bytecode of dialect '" << getDialect()->getNamespace()
+                                   << "' has version " << value
+                                   << ", newer than the supported version " << version;
+                return nullptr;
+            }
+
+            return std::make_unique< dialect_version >(value);
+        }
+
+        logical_result upgradeFromVersion(
+            operation /* top */, const mlir::DialectVersion & /* from */
+        ) const override {
+            // No incompatible changes so far, all versions are read as they are.
+            return mlir::success();
+        }
+    };
+
+} // namespace vast
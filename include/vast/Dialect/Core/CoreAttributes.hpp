@@ -7,7 +7,9 @@
 VAST_RELAX_WARNINGS
 #include <llvm/ADT/APSInt.h>
 #include <llvm/Support/Locale.h>
+#include <mlir/Dialect/DLTI/DLTI.h>
 #include <mlir/IR/BuiltinAttributes.h>
+#include <mlir/Interfaces/DataLayoutInterfaces.h>
 VAST_UNRELAX_WARNINGS
 
 #include "vast/Dialect/Core/CoreDialect.hpp"
@@ -16,13 +18,9 @@ VAST_UNRELAX_WARNINGS
 #include "vast/Util/Common.hpp"
 #include "vast/Util/TypeList.hpp"
 
+namespace vast::dl {
+    struct DLEntry;
+} // namespace vast::dl
+
 #define GET_ATTRDEF_CLASSES
 #include "vast/Dialect/Core/CoreAttributes.h.inc"
-
-namespace vast::core {
-
-    using typed_attrs = util::type_list<
-        BooleanAttr, IntegerAttr, FloatAttr, VoidAttr
-    >;
-
-} // namespace vast::core
@@ -5,6 +5,8 @@
 #include "vast/Util/Warnings.hpp"
 
 VAST_RELAX_WARNINGS
+#include "mlir/Dialect/DLTI/DLTI.h"
+#include "mlir/Dialect/LLVMIR/LLVMDialect.h"
 #include "mlir/IR/Dialect.h"
 VAST_UNRELAX_WARNINGS
 
@@ -36,4 +38,23 @@ namespace vast {
         mctx.appendDialectRegistry(registry);
     }
 
+    // Dialects VAST modules are made of. Other dialects are not needed
+    // up front, passes load them on demand as their dependent dialects.
+    inline void registerDefaultDialects(mlir::DialectRegistry &registry) {
+        vast::registerAllDialects(registry);
+        registry.insert< mlir::DLTIDialect, mlir::LLVM::LLVMDialect >();
+    }
+
+    // Loads only the default dialects, the builtin dialect is always loaded.
+    // Dialects present in the registry of the context stay available to be
+    // loaded lazily on first use.
+    inline void loadDefaultDialects(mcontext_t &mctx) {
+        mlir::DialectRegistry registry;
+        vast::registerDefaultDialects(registry);
+        mctx.appendDialectRegistry(registry);
+        for (auto name : registry.getDialectNames()) {
+            mctx.getOrLoadDialect(name);
+        }
+    }
+
 } // namespace vast
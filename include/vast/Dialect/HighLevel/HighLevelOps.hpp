@@ -8,6 +8,7 @@ VAST_RELAX_WARNINGS
 #include <mlir/IR/BuiltinDialect.h>
 #include <mlir/IR/FunctionInterfaces.h>
 #include <mlir/Interfaces/InferTypeOpInterface.h>
+#include <mlir/Interfaces/SideEffectInterfaces.h>
 VAST_UNRELAX_WARNINGS
 
 #include <gap/core/generator.hpp>
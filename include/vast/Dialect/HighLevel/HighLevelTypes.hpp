@@ -121,18 +121,25 @@ namespace vast::hl
         }
     }
 
-    core::FunctionType getFunctionType(mlir_type function_pointer, vast_module mod);
+    struct typedef_resolver;
 
-    core::FunctionType getFunctionType(Value callee);
-    core::FunctionType getFunctionType(mlir::CallOpInterface call);
-    core::FunctionType getFunctionType(mlir::CallInterfaceCallable callee, vast_module mod);
+    // Typedefs are resolved by the `typedef_resolver` analysis from the scope
+    // of `user`, or of the operation the callee comes from.
+    core::FunctionType getFunctionType(
+        mlir_type function_pointer, operation user, const typedef_resolver &typedefs
+    );
+
+    core::FunctionType getFunctionType(Value callee, const typedef_resolver &typedefs);
+    core::FunctionType getFunctionType(mlir::CallOpInterface call, const typedef_resolver &typedefs);
+    core::FunctionType getFunctionType(
+        mlir::CallInterfaceCallable callee, vast_module mod, const typedef_resolver &typedefs
+    );
 
     mlir_type getTypedefType(TypedefType type, vast_module mod);
 
     // unwraps all typedef aliases to get to real underlying type
-    mlir_type getBottomTypedefType(TypedefType def, vast_module mod);
-
-    mlir_type getBottomTypedefType(mlir_type type, vast_module mod);
+    mlir_type getBottomTypedefType(TypedefType def, operation user, const typedef_resolver &typedefs);
+    mlir_type getBottomTypedefType(mlir_type type, operation user, const typedef_resolver &typedefs);
 
     // Usually record types are wrapped in `elaborated` or `lvalue` - this helper
     // takes care of traversing them.
@@ -6,6 +6,7 @@
 #include "vast/Dialect/HighLevel/HighLevelDialect.hpp"
 #include "vast/Dialect/HighLevel/HighLevelOps.hpp"
 #include "vast/Dialect/HighLevel/HighLevelTypes.hpp"
+#include "vast/Dialect/HighLevel/RecordIndex.hpp"
 #include "vast/Interfaces/SymbolInterface.hpp"
 
 #include "vast/Util/Common.hpp"
@@ -44,30 +45,21 @@ namespace vast::hl {
         }
     }
 
-    // TODO(hl): This is a placeholder that works in our test cases so far.
-    //           In general, we will need generic resolution for scoping that
-    //           will be used instead of this function.
-    static inline auto definition_of(mlir::Type t, vast_module module_op)
+    // TODO(hl): This works in our test cases so far. In general, we will
+    //           need generic resolution for scoping that will be used instead
+    //           of the name based lookup.
+    static inline auto definition_of(mlir::Type t, const record_index &records)
         -> AggregateTypeDefinitionInterface {
-        auto type_name = hl::name_of_record(t);
-        VAST_CHECK(type_name, "hl::name_of_record failed with {0}", t);
-
-        AggregateTypeDefinitionInterface out;
-        ;
-        auto walker = [&](AggregateTypeDefinitionInterface op) {
-            if (op.getDefinedName() == type_name) {
-                out = op;
-                return mlir::WalkResult::interrupt();
-            }
-            return mlir::WalkResult::advance();
-        };
-        module_op->walk(walker);
-        return out;
+        VAST_CHECK(
+            mlir::isa< hl::RecordType >(strip_elaborated(strip_value_category(t))),
+            "hl::definition_of expects a record type, got {0}", t
+        );
+        return records.definition_of(t);
     }
 
-    static inline auto field_types(mlir::Type t, vast_module module_op)
+    static inline auto field_types(mlir::Type t, const record_index &records)
         -> gap::generator< mlir_type > {
-        auto def = definition_of(t, module_op);
+        auto def = definition_of(t, records);
         VAST_CHECK(def, "Was not able to fetch definition of type: {0}", t);
         return def.getFieldTypes();
     }
@@ -82,27 +74,28 @@ namespace vast::hl {
     }
 
     // Given record `root` emit `hl::RecordMemberOp` for each its member.
-    static inline auto generate_ptrs_to_record_members(operation root, auto loc, auto &bld)
-        -> gap::generator< hl::RecordMemberOp > {
-        auto module_op = root->getParentOfType< vast_module >();
-        VAST_ASSERT(module_op);
-        auto def = definition_of(root->getResultTypes()[0], module_op);
+    static inline auto generate_ptrs_to_record_members(
+        operation root, auto loc, auto &bld, const record_index &records
+    ) -> gap::generator< hl::RecordMemberOp > {
+        auto def = definition_of(root->getResultTypes()[0], records);
         VAST_CHECK(def, "Was not able to fetch definition of type from: {0}", *root);
 
         for (const auto &[name, type] : def.getFieldsInfo()) {
             VAST_ASSERT(root->getNumResults() == 1);
             auto as_val    = root->getResult(0);
             // `hl.member` requires type to be an lvalue.
-            auto wrap_type = hl::LValueType::get(module_op.getContext(), type);
+            auto wrap_type = hl::LValueType::get(root->getContext(), type);
             co_yield bld.template create< hl::RecordMemberOp >(loc, wrap_type, as_val, name);
         }
     }
 
     // Given record `root` emit `hl::RecordMemberOp` casted as rvalue for each
     // its member.
-    static inline auto generate_values_of_record_members(operation root, auto &bld)
-        -> gap::generator< hl::ImplicitCastOp > {
-        for (auto member_ptr : generate_ptrs_to_members(root, bld)) {
+    static inline auto generate_values_of_record_members(
+        operation root, auto &bld, const record_index &records
+    ) -> gap::generator< hl::ImplicitCastOp > {
+        auto loc = root->getLoc();
+        for (auto member_ptr : generate_ptrs_to_record_members(root, loc, bld, records)) {
             co_yield implicit_cast_lvalue_to_rvalue(bld, member_ptr->getLoc(), member_ptr);
         }
     }
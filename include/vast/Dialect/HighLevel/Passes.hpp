@@ -39,6 +39,8 @@ namespace vast::hl {
 
         pipeline_step_ptr simplify();
 
+        pipeline_step_ptr fold();
+
         pipeline_step_ptr stdtypes();
     } // namespace pipeline
 
@@ -0,0 +1,108 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#pragma once
+
+#include "vast/Util/Warnings.hpp"
+
+VAST_RELAX_WARNINGS
+#include <llvm/ADT/StringMap.h>
+#include <mlir/Pass/AnalysisManager.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Dialect/HighLevel/HighLevelOps.hpp"
+#include "vast/Dialect/HighLevel/HighLevelTypes.hpp"
+#include "vast/Interfaces/AggregateTypeDefinitionInterface.hpp"
+
+#include "vast/Util/Common.hpp"
+
+#include <optional>
+
+namespace vast::hl {
+
+    //
+    // Module level index of record definitions.
+    //
+    // Maps the name of each `AggregateTypeDefinitionInterface` operation to
+    // the operation itself and to the table of indices of its fields. The
+    // index is built by a single walk of the root operation and is meant to
+    // be used as an MLIR analysis:
+    //
+    //   const auto &records = getAnalysis< hl::record_index >();
+    //
+    // Passes that neither create nor erase record definitions should mark
+    // the analysis as preserved, so that it is shared across the pipeline.
+    // Passes that do change the set of definitions leave it invalidated and
+    // the index is rebuilt on the next request.
+    //
+    struct record_index
+    {
+        struct record_info
+        {
+            AggregateTypeDefinitionInterface decl;
+            llvm::StringMap< std::size_t > fields;
+
+            explicit record_info(AggregateTypeDefinitionInterface decl) : decl(decl) {
+                std::size_t idx = 0;
+                // `llvm::enumerate` is unhappy when coroutine is passed in.
+                for (const auto &[name, _] : decl.getFieldsInfo()) {
+                    // Keep the first occurence to mirror linear lookup.
+                    fields.try_emplace(name, idx++);
+                }
+            }
+
+            std::optional< std::size_t > field_idx(string_ref name) const {
+                if (auto it = fields.find(name); it != fields.end()) {
+                    return it->second;
+                }
+                return std::nullopt;
+            }
+        };
+
+        explicit record_index(operation root) {
+            // The walk order matches the original lookup, that returned the first
+            // definition found by the post-order module walk.
+            root->walk([&](AggregateTypeDefinitionInterface decl) {
+                records.try_emplace(decl.getDefinedName(), decl);
+            });
+        }
+
+        const record_info *lookup(string_ref name) const {
+            if (auto it = records.find(name); it != records.end()) {
+                return &it->second;
+            }
+            return nullptr;
+        }
+
+        const record_info *lookup(mlir_type type) const {
+            auto naked = strip_elaborated(strip_value_category(type));
+            if (auto record = mlir::dyn_cast< hl::RecordType >(naked)) {
+                return lookup(record.getName());
+            }
+            return nullptr;
+        }
+
+        AggregateTypeDefinitionInterface definition_of(mlir_type type) const {
+            if (auto info = lookup(type)) {
+                return info->decl;
+            }
+            return {};
+        }
+
+        std::optional< std::size_t > field_idx(mlir_type type, string_ref field) const {
+            if (auto info = lookup(type)) {
+                return info->field_idx(field);
+            }
+            return std::nullopt;
+        }
+
+        std::size_t size() const { return records.size(); }
+
+        bool isInvalidated(const mlir::AnalysisManager::PreservedAnalyses &pa) const {
+            return !pa.isPreserved< record_index >();
+        }
+
+      private:
+        llvm::StringMap< record_info > records;
+    };
+
+} // namespace vast::hl
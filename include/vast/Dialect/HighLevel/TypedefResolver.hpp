@@ -0,0 +1,144 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#pragma once
+
+#include "vast/Util/Warnings.hpp"
+
+VAST_RELAX_WARNINGS
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/StringMap.h>
+#include <mlir/Pass/AnalysisManager.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Dialect/HighLevel/HighLevelOps.hpp"
+#include "vast/Dialect/HighLevel/HighLevelTypes.hpp"
+
+#include "vast/Util/Common.hpp"
+
+namespace vast::hl {
+
+    //
+    // Module level resolver of typedef chains.
+    //
+    // Maps each `TypeDefOp` to the type it aliases and to the bottom type of
+    // its typedef chain. Typedefs are keyed by their scope, i.e., the parent
+    // operation of the definition, and a name is resolved from the operation
+    // that uses it through the enclosing scopes, so that local typedefs shadow
+    // the outer ones. Both tables are computed by a single walk of the root
+    // operation. It is meant to be used as an MLIR analysis:
+    //
+    //   const auto &typedefs = getAnalysis< hl::typedef_resolver >();
+    //
+    // Passes that do not touch typedef definitions should mark the analysis
+    // as preserved. Passes that only rewrite types can keep the cached types
+    // in sync through `map_types`.
+    //
+    struct typedef_resolver
+    {
+        explicit typedef_resolver(operation root) {
+            root->walk([&](TypeDefOp op) {
+                aliases[op->getParentOp()][op.getName()] = op.getType();
+            });
+
+            for (const auto &[scope, names] : aliases) {
+                for (const auto &entry : names) {
+                    resolve(scope, entry.getKey());
+                }
+            }
+        }
+
+        // Type directly aliased by typedef `name` visible from `user`, null
+        // if unknown.
+        mlir_type aliased(string_ref name, operation user) const {
+            return find(aliases, lookup(name, user), name);
+        }
+
+        mlir_type aliased(TypedefType type, operation user) const {
+            return aliased(type.getName(), user);
+        }
+
+        // Unwraps all typedef aliases to get to real underlying type.
+        mlir_type bottom(TypedefType type, operation user) const {
+            return find(bottoms, lookup(type.getName(), user), type.getName());
+        }
+
+        mlir_type bottom(mlir_type type, operation user) const {
+            if (auto def = mlir::dyn_cast_or_null< TypedefType >(strip_elaborated(type))) {
+                return bottom(def, user);
+            }
+            return type;
+        }
+
+        // Applies `fn` to every cached type, used by passes that rewrite types
+        // of typedef definitions in place.
+        void map_types(auto &&fn) {
+            for (auto &[scope, names] : aliases) {
+                for (auto &entry : names) {
+                    entry.second = fn(entry.second);
+                }
+            }
+            for (auto &[scope, names] : bottoms) {
+                for (auto &entry : names) {
+                    entry.second = fn(entry.second);
+                }
+            }
+        }
+
+        std::size_t size() const {
+            std::size_t count = 0;
+            for (const auto &[scope, names] : aliases) {
+                count += names.size();
+            }
+            return count;
+        }
+
+        bool isInvalidated(const mlir::AnalysisManager::PreservedAnalyses &pa) const {
+            return !pa.isPreserved< typedef_resolver >();
+        }
+
+      private:
+        using scoped_types = llvm::DenseMap< operation, llvm::StringMap< mlir_type > >;
+
+        // Innermost scope enclosing `user` that defines `name`.
+        operation lookup(string_ref name, operation user) const {
+            for (auto scope = user; scope; scope = scope->getParentOp()) {
+                if (auto it = aliases.find(scope); it != aliases.end()) {
+                    if (it->second.contains(name)) {
+                        return scope;
+                    }
+                }
+            }
+            return nullptr;
+        }
+
+        static mlir_type find(const scoped_types &types, operation scope, string_ref name) {
+            if (auto it = types.find(scope); it != types.end()) {
+                if (auto type = it->second.find(name); type != it->second.end()) {
+                    return type->second;
+                }
+            }
+            return {};
+        }
+
+        mlir_type resolve(operation scope, string_ref name) {
+            if (auto type = find(bottoms, scope, name)) {
+                return type;
+            }
+
+            auto type = aliases[scope][name];
+            if (auto def = mlir::dyn_cast_or_null< TypedefType >(strip_elaborated(type))) {
+                // `typedef T T` in a nested scope refers to the outer `T`.
+                auto from = def.getName() == name ? scope->getParentOp() : scope;
+                auto def_scope = lookup(def.getName(), from);
+                type = def_scope ? resolve(def_scope, def.getName()) : mlir_type();
+            }
+
+            bottoms[scope][name] = type;
+            return type;
+        }
+
+        scoped_types aliases;
+        scoped_types bottoms;
+    };
+
+} // namespace vast::hl
@@ -111,6 +111,15 @@ namespace vast::cc {
         virtual void anchor();
     };
 
+    //
+    // Emit MLIR bytecode
+    //
+    struct emit_mlir_bytecode_action : vast_stream_action {
+        explicit emit_mlir_bytecode_action(const vast_args &vargs);
+    private:
+        virtual void anchor();
+    };
+
     //
     // Emit obj
     //
@@ -0,0 +1,73 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#pragma once
+
+#include "vast/Util/Warnings.hpp"
+
+VAST_RELAX_WARNINGS
+#include <mlir/IR/BuiltinOps.h>
+#include <mlir/IR/SymbolTable.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Util/Common.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vast::cc {
+
+    //
+    // On-disk cache of lowered functions.
+    //
+    // A function definition is keyed by its high-level IR including
+    // locations, by module-level operations it refers to (only signatures of
+    // referred functions), by attributes of the module, e.g., the data
+    // layout, by the pipeline configuration and by the identity of the
+    // compiler.
+    //
+    // Bodies of cached functions are dropped before the pipeline runs, so
+    // that they are lowered as mere declarations, and replaced by the cached
+    // lowered functions afterwards. Lowered functions are stored together
+    // with declarations of module-level operations they refer to. String
+    // literals among them are renamed on load if their names are taken,
+    // functions referring to other operations the module does not have are
+    // treated as misses.
+    //
+    struct compilation_cache
+    {
+        // `configuration` identifies the pipeline, e.g., the target dialect
+        // and the disabled steps.
+        compilation_cache(std::string directory, std::string configuration);
+
+        // Drops bodies of functions of `mod` that are cached.
+        void prepare(vast_module mod);
+
+        // Replaces declarations of cached functions by their cached lowering
+        // and stores the lowering of the remaining functions.
+        logical_result finish(vast_module mod);
+
+        std::int64_t hits   = 0;
+        std::int64_t misses = 0;
+
+      private:
+        struct entry_t
+        {
+            std::string name;
+            std::string key;
+            // Loaded lowering of the function if cached.
+            mlir::OwningOpRef< mlir::ModuleOp > cached;
+        };
+
+        std::string path_of(string_ref key) const;
+
+        mlir::OwningOpRef< mlir::ModuleOp > load(string_ref key, mcontext_t &mctx) const;
+        void store(string_ref key, operation lowered, mlir::SymbolTable &symbols) const;
+
+        std::string directory;
+        std::string configuration;
+
+        std::vector< entry_t > entries;
+    };
+
+} // namespace vast::cc
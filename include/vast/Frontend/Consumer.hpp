@@ -17,6 +17,8 @@ VAST_UNRELAX_WARNINGS
 #include "vast/CodeGen/CodeGenContext.hpp"
 #include "vast/CodeGen/CodeGenDriver.hpp"
 
+#include "vast/Util/PipelineStatistics.hpp"
+
 namespace vast::cc {
 
     using output_stream_ptr = std::unique_ptr< llvm::raw_pwrite_stream >;
@@ -25,14 +27,18 @@ namespace vast::cc {
 
     using backend = clang::BackendAction;
 
+    // The backend sets process-wide command line options from some of the
+    // code generation options and times itself with global timers if asked
+    // to. Such backends must not run concurrently with any other one, neither
+    // partitions of a module nor translation units of the batch mode.
+    bool is_backend_reentrant(const clang::CodeGenOptions &opts);
+
     struct vast_consumer : clang_ast_consumer
     {
         vast_consumer(action_options opts, const vast_args &vargs)
             : opts(std::move(opts)), vargs(vargs)
         {}
 
-        void Initialize(acontext_t &ctx) override;
-
         bool HandleTopLevelDecl(clang::DeclGroupRef decls) override;
 
         void HandleCXXStaticMemberVarInstantiation(clang::VarDecl * /* decl */) override;
@@ -76,6 +82,13 @@ namespace vast::cc {
         std::unique_ptr< mcontext_t > mctx = nullptr;
         std::unique_ptr< cg::codegen_context > cgctx = nullptr;
         std::unique_ptr< cg::codegen_driver > codegen = nullptr;
+
+        // Code generation measured for pipeline statistics, if requested.
+        // Only the callbacks of the consumer are measured, not parsing done
+        // by clang in between.
+        bool statistics_enabled() const;
+        std::optional< pipeline_statistics::phase_timer > codegen_timer;
+        std::optional< pipeline_statistics::record > codegen_phase;
     };
 
     struct vast_stream_consumer : vast_consumer {
@@ -90,6 +103,10 @@ namespace vast::cc {
         void HandleTranslationUnit(acontext_t &acontext) override;
 
       private:
+        // Whether locations of the output are printed or lowered, lazy
+        // locations are expanded only then.
+        bool needs_locations() const;
+
         void emit_backend_output(
             backend backend_action, owning_module_ref mlir_module, mcontext_t *mctx
         );
@@ -98,7 +115,22 @@ namespace vast::cc {
             target_dialect target, owning_module_ref mod, mcontext_t *mctx
         );
 
-        void process_mlir_module(
+        // Number of partitions of the LLVM module compiled in parallel.
+        unsigned backend_jobs() const;
+
+        // Hash of the absolute output and main file paths.
+        std::uint64_t unit_hash(string_ref output) const;
+
+        // Emits an output per partition of the module: `foo.o`, `foo.1.o`,
+        // ... Returns false if the module is not partitioned.
+        bool emit_partitioned_output(
+            backend backend_action, vast_module mod, mcontext_t *mctx,
+            pipeline_statistics *stats
+        );
+
+        // Returns the pipeline that was run, its statistics are reported
+        // once it is released.
+        std::unique_ptr< pipeline_t > process_mlir_module(
             target_dialect target, mlir::ModuleOp mod, mcontext_t *mctx
         );
 
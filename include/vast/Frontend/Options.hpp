@@ -72,10 +72,19 @@ namespace vast::cc
         constexpr string_ref emit_obj  = "emit-obj";
         constexpr string_ref emit_asm  = "emit-asm";
         constexpr string_ref emit_mlir = "emit-mlir";
+        constexpr string_ref emit_mlir_bytecode = "emit-mlir-bytecode";
 
         constexpr string_ref print_pipeline = "print-pipeline";
         constexpr string_ref emit_crash_reproducer = "emit-crash-reproducer";
 
+        constexpr string_ref time_passes = "time-passes";
+        constexpr string_ref pass_statistics = "pass-statistics";
+        constexpr string_ref profile_patterns = "profile-patterns";
+
+        constexpr string_ref batch = "batch";
+        constexpr string_ref compilation_cache = "compilation-cache";
+        constexpr string_ref backend_jobs = "backend-jobs";
+
         constexpr string_ref disable_multithreading = "disable-multithreading";
         constexpr string_ref debug = "debug";
 
@@ -85,6 +94,7 @@ namespace vast::cc
 
         constexpr string_ref show_locs = "show-locs";
         constexpr string_ref locs_as_meta_ids = "locs-as-meta-ids";
+        constexpr string_ref lazy_locs = "lazy-locs";
 
         constexpr string_ref disable_vast_verifier = "disable-vast-verifier";
         constexpr string_ref vast_verify_diags = "verify-diags";
@@ -0,0 +1,44 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#pragma once
+
+#include "vast/Util/Warnings.hpp"
+
+VAST_RELAX_WARNINGS
+#include <llvm/Support/ThreadPool.h>
+#include <mlir/IR/DialectRegistry.h>
+#include <mlir/IR/MLIRContext.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Util/Common.hpp"
+
+#include <memory>
+
+namespace vast::cc {
+
+    //
+    // Process wide state shared by translation units compiled in a single
+    // `vast-front` process, e.g., in the batch mode.
+    //
+    // The dialect registry is populated once and only read afterwards, so
+    // contexts of concurrently compiled translation units can be created
+    // from it. All contexts also share a single thread pool instead of
+    // spawning their own pool per translation unit.
+    //
+    struct shared_context_state
+    {
+        explicit shared_context_state(llvm::ThreadPoolStrategy strategy);
+
+        mlir::DialectRegistry registry;
+        llvm::ThreadPool pool;
+    };
+
+    // Installs `state` to be used by `make_mcontext`, passing `nullptr`
+    // restores creation of standalone contexts. Not thread-safe, needs to be
+    // called before translation units are processed.
+    void set_shared_context_state(shared_context_state *state);
+
+    // Creates the context for a single translation unit.
+    std::unique_ptr< mcontext_t > make_mcontext();
+
+} // namespace vast::cc
@@ -9,6 +9,7 @@ namespace vast::cc {
     enum class output_type {
         emit_assembly,
         emit_mlir,
+        emit_mlir_bytecode,
         emit_llvm,
         emit_obj,
         none
@@ -11,6 +11,7 @@ VAST_RELAX_WARNINGS
 #include <mlir/IR/OperationSupport.h>
 VAST_RELAX_WARNINGS
 
+#include "vast/Dialect/Core/CoreAttributes.hpp"
 #include "vast/Util/DataLayout.hpp"
 
 namespace vast
@@ -18,6 +19,8 @@ namespace vast
     // Shared utility by `DefaultDataLayoutTypeInterface` to correctly
     // filter data layout entries. Once one is selected it will be casted
     // to `DLEntry` and passed `extract` to produce resulting value.
+    // Entries of `core::DataLayoutTableAttr` are looked up by the type
+    // directly.
     // TODO(interface): Return can be generic based on what `extract` returns.
     template< typename ConcreteType, typename Interface, typename Extract >
     unsigned default_dl_query(const Interface &self, Extract &&extract,
@@ -26,6 +29,18 @@ namespace vast
     {
         VAST_CHECK(entries.size() != 0, "Data layout query did not match to any dl entry!");
 
+        auto casted_self = static_cast< const ConcreteType & >(self);
+
+        if (entries.size() == 1) {
+            auto value = entries.front().getValue();
+            if (auto table = mlir::dyn_cast< core::DataLayoutTableAttr >(value)) {
+                auto entry = table.lookup(casted_self);
+                VAST_CHECK(entry, "Data layout query of {0} did not produce a value!",
+                           casted_self);
+                return extract(*entry);
+            }
+        }
+
         std::optional< unsigned > out;
         auto handle_entry = [&](const auto &entry)
         {
@@ -38,7 +53,6 @@ namespace vast
                        *out, current, entries.size());
         };
 
-        auto casted_self = static_cast< const ConcreteType & >(self);
         for (const auto &entry : entries)
         {
             auto raw = dl::DLEntry(entry);
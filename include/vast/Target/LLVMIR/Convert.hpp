@@ -32,6 +32,18 @@ namespace vast::target::llvmir
         vast_module mlir_module, llvm::LLVMContext &llvm_ctx
     );
 
+    // Rewrites module attributes to the form expected by the translation and
+    // registers the translation interfaces. Modifies the context, hence it
+    // must not run concurrently with other translations.
+    void prepare_module(vast_module mlir_module);
+
+    // Translates a module already passed to `prepare_module` (or a partition of
+    // one). Modules of the same context can be translated concurrently, each
+    // into its own `llvm::LLVMContext`.
+    std::unique_ptr< llvm::Module > translate_prepared(
+        vast_module mlir_module, llvm::LLVMContext &llvm_ctx
+    );
+
     void register_vast_to_llvm_ir(mlir::DialectRegistry &registry);
     void register_vast_to_llvm_ir(mcontext_t &mctx);
 
@@ -0,0 +1,36 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#pragma once
+
+#include "vast/Util/Warnings.hpp"
+#include "vast/Util/Common.hpp"
+
+#include <vector>
+
+namespace vast::target::llvmir
+{
+    //
+    // Splits a module in the LLVM dialect into at most `count` modules that
+    // can be translated and compiled independently, e.g., in parallel.
+    //
+    // Function definitions are distributed by size, each partition declares
+    // the rest. Global variables are defined in the partition of their users
+    // if they have a single one, otherwise in the first partition; global
+    // constructors and destructors stay in the first partition. Definitions
+    // with linkonce or weak linkage are copied to every partition as the
+    // linker merges them anyway.
+    //
+    // Local functions are copied to every partition that refers to them and
+    // stay local, so that they can still be inlined. Local globals used across
+    // partitions are made external with hidden visibility and renamed with
+    // `unique_suffix`, which should be unique for the translation unit, so
+    // that they do not clash with symbols of other objects.
+    //
+    // Returns no partitions if the module cannot be split, i.e., if it has
+    // less than two function definitions to distribute.
+    //
+    std::vector< owning_module_ref > partition_module(
+        vast_module mod, unsigned count, string_ref unique_suffix
+    );
+
+} // namespace vast::target::llvmir
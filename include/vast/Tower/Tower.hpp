@@ -5,25 +5,39 @@
 #include "vast/Util/Common.hpp"
 
 VAST_RELAX_WARNINGS
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/StringMap.h>
+#include <llvm/ADT/StringSet.h>
+#include <mlir/IR/IRMapping.h>
+#include <mlir/Interfaces/FunctionInterfaces.h>
 #include <mlir/Pass/PassManager.h>
 VAST_UNRELAX_WARNINGS
 
-namespace vast::tw {
+#include <optional>
+#include <vector>
 
-    struct default_loc_rewriter_t
-    {
-        static auto insert(mlir::Operation *op) -> void;
-        static auto remove(mlir::Operation *op) -> void;
-        static auto prev(mlir::Operation *op) -> mlir::Operation *;
-    };
+namespace vast::tw {
 
     using pass_ptr_t = std::unique_ptr< mlir::Pass >;
 
-    template< typename loc_rewriter_t >
+    //
+    // Tower of modules, each level is produced by a pass pipeline applied to
+    // its parent level.
+    //
+    // Passes run on whole modules, hence a pipeline is applied to a complete
+    // clone of its level. Levels other than the top are not meant to be
+    // modified. Once a level is frozen, i.e., another level is applied after
+    // it, bodies of parent functions left untouched by its pipeline are
+    // dropped and the parent refers to the equal function of the child
+    // instead. The memory of the tower thus grows with the functions changed
+    // by each level. The bodies are cloned back on demand by `materialize`,
+    // hence only the top level is guaranteed to be complete.
+    //
+    // Back-links from operations to the parent operations they were cloned
+    // from are kept in a side table of each level, see `prev`.
+    //
     struct tower
     {
-        using loc_rewriter = loc_rewriter_t;
-
         struct handle_t
         {
             std::size_t id;
@@ -33,26 +47,11 @@ namespace vast::tw {
         static auto get(mcontext_t &ctx, owning_module_ref mod)
             -> std::tuple< tower, handle_t > {
             tower t(ctx, std::move(mod));
-            handle_t h{ .id = 0, .mod = t._modules[0].get() };
+            handle_t h{ .id = 0, .mod = t._levels[0].mod.get() };
             return { std::move(t), h };
         }
 
-        auto apply(handle_t handle, mlir::PassManager &pm) -> handle_t {
-            handle.mod.walk(loc_rewriter::insert);
-
-            _modules.emplace_back(mlir::cast< vast_module >(handle.mod->clone()));
-
-            auto id  = _modules.size() - 1;
-            auto mod = _modules.back().get();
-
-            if (mlir::failed(pm.run(mod))) {
-                VAST_FATAL("some pass in apply() failed");
-            }
-
-            handle.mod.walk(loc_rewriter::remove);
-
-            return { id, mod };
-        }
+        auto apply(handle_t handle, mlir::PassManager &pm) -> handle_t;
 
         auto apply(handle_t handle, pass_ptr_t pass) -> handle_t {
             mlir::PassManager pm(_ctx);
@@ -60,19 +59,62 @@ namespace vast::tw {
             return apply(handle, pm);
         }
 
-        auto top() -> handle_t { return { _modules.size(), _modules.back().get() }; }
+        auto top() -> handle_t { return { _levels.size() - 1, _levels.back().mod.get() }; }
+
+        auto bottom() -> handle_t { return { 0, _levels.front().mod.get() }; }
+
+        auto size() const -> std::size_t { return _levels.size(); }
+
+        auto level(std::size_t id) -> handle_t;
+
+        // Level the pipeline producing `handle` was applied to.
+        auto parent(handle_t handle) -> std::optional< handle_t >;
+
+        // Whether the body of function `fn` was dropped in favour of the equal
+        // function of a child level.
+        auto is_shared(handle_t handle, string_ref fn) const -> bool;
+
+        // Restores all function bodies of the level shared with its children.
+        auto materialize(handle_t handle) -> void;
+
+        // Operation of the parent level, that `op` of level `handle` was
+        // cloned from. Null for operations created by the pipeline and for
+        // operations of the bottom level.
+        auto prev(handle_t handle, operation op) -> operation;
 
       private:
-        using module_storage_t = llvm::SmallVector< owning_module_ref, 2 >;
+        struct level_t
+        {
+            owning_module_ref mod;
+            std::optional< std::size_t > parent;
+            std::size_t children = 0;
+
+            // Back-links to operations of the parent level.
+            llvm::DenseMap< operation, operation > links;
+
+            // Functions equal to the parent function, their links are
+            // resolved on demand.
+            llvm::StringSet<> unresolved;
+
+            // Functions with dropped bodies mapped to the level of the
+            // equal function they are restored from.
+            llvm::StringMap< std::size_t > stubs;
+        };
+
+        auto share_functions(std::size_t parent, std::size_t child) -> void;
+        auto drop_body(std::size_t id, mlir::FunctionOpInterface fn) -> void;
+
+        auto materialize(std::size_t id, string_ref fn) -> void;
+        auto resolve_links(std::size_t id, string_ref fn) -> void;
 
         mcontext_t *_ctx;
-        module_storage_t _modules;
+        std::vector< level_t > _levels;
 
         tower(mcontext_t &ctx, owning_module_ref mod) : _ctx(&ctx) {
-            _modules.emplace_back(std::move(mod));
+            _levels.push_back({ .mod = std::move(mod) });
         }
     };
 
-    using default_tower = tower< default_loc_rewriter_t >;
+    using default_tower = tower;
 
 } // namespace vast::tw
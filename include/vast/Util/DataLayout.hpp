@@ -14,6 +14,7 @@ VAST_RELAX_WARNINGS
 #include <mlir/Interfaces/DataLayoutInterfaces.h>
 VAST_UNRELAX_WARNINGS
 
+#include "vast/Dialect/Core/CoreAttributes.hpp"
 #include "vast/Util/Common.hpp"
 
 #include <type_traits>
@@ -99,6 +100,10 @@ namespace vast::dl {
     struct DataLayoutBlueprint
     {
         bool try_emplace(mlir_type mty, const clang::Type *aty, const acontext_t &actx) {
+            if (entries.count(mty)) {
+                return false;
+            }
+
             // For other types this should be good-enough for now
             auto info      = actx.getTypeInfo(aty);
             auto bw        = static_cast< uint32_t >(info.Width);
@@ -117,12 +122,15 @@ namespace vast::dl {
             entries.try_emplace(type, entry);
         }
 
+        // Entries are emitted hashed, so that queries do not scan them.
         auto wrap(mcontext_t &mctx) const {
             std::vector< mlir::DataLayoutEntryInterface > flattened;
             for (const auto &[_, e] : entries) {
                 flattened.push_back(e.wrap(mctx));
             }
-            return mlir::DataLayoutSpecAttr::get(&mctx, flattened);
+            return core::DataLayoutTableAttr::get(
+                &mctx, mlir::DataLayoutSpecAttr::get(&mctx, flattened)
+            );
         }
 
         llvm::DenseMap< mlir_type, dl::DLEntry > entries;
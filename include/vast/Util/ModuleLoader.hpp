@@ -0,0 +1,62 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#pragma once
+
+#include "vast/Util/Warnings.hpp"
+
+VAST_RELAX_WARNINGS
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/SourceMgr.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Util/Common.hpp"
+
+#include <memory>
+
+namespace mlir {
+    class BytecodeReader;
+} // namespace mlir
+
+namespace vast {
+
+    //
+    // Module read from textual MLIR or MLIR bytecode.
+    //
+    // If a bytecode input is loaded lazily, bodies of functions stay in the
+    // input buffer until they are materialized, so that tools pay only for
+    // the functions they touch. Textual inputs are always parsed eagerly.
+    // Errors are reported through the diagnostics of the context.
+    //
+    struct module_loader
+    {
+        using memory_buffer = std::unique_ptr< llvm::MemoryBuffer >;
+
+        module_loader(mcontext_t &mctx, memory_buffer buffer, bool lazy);
+        ~module_loader();
+
+        // Null if the input failed to load.
+        vast_module get() const { return mod.get(); }
+
+        explicit operator bool() const { return static_cast< bool >(mod); }
+
+        // Releases the module, remaining lazy bodies are materialized first.
+        owning_module_ref take();
+
+        bool is_materializable(operation op);
+
+        // Materializes the body of `op`, functions nested in it stay lazy.
+        logical_result materialize(operation op);
+
+        // Materializes all remaining lazy bodies.
+        logical_result materialize_all();
+
+      private:
+        mcontext_t &mctx;
+        std::shared_ptr< llvm::SourceMgr > source_mgr;
+
+        owning_module_ref mod;
+        // Refers to operations of the module, hence needs to be released first.
+        std::unique_ptr< mlir::BytecodeReader > reader;
+    };
+
+} // namespace vast
@@ -0,0 +1,87 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#pragma once
+
+#include "vast/Util/Warnings.hpp"
+
+VAST_RELAX_WARNINGS
+#include <llvm/ADT/StringMap.h>
+#include <llvm/Support/raw_ostream.h>
+#include <mlir/Pass/PassInstrumentation.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Util/Common.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <optional>
+
+namespace vast {
+
+    //
+    // Match attempts, successes, failures and cumulative time of rewrite
+    // patterns per root operation.
+    //
+    // Patterns of conversion passes are wrapped by `profiled_pattern` (see
+    // Conversion/Common/ProfiledPattern.hpp) when they are populated while a
+    // profile is active. The wrappers report each attempt to the active
+    // profile, which is shared by all threads of the pipeline.
+    //
+    struct pattern_profile
+    {
+        using clock = std::chrono::steady_clock;
+
+        struct record {
+            std::string pattern;
+            std::string root;
+
+            std::uint64_t successes = 0;
+            std::uint64_t failures  = 0;
+            clock::duration time    = {};
+
+            std::uint64_t attempts() const { return successes + failures; }
+        };
+
+        // Profile to which wrapped patterns report, null if none is active.
+        static pattern_profile *active() { return current.load(std::memory_order_acquire); }
+
+        void add(string_ref pattern, string_ref root, bool success, clock::duration time);
+
+        // Records sorted by cumulative time.
+        std::vector< record > sorted_records() const;
+
+        void print_table(llvm::raw_ostream &os) const;
+        void print_json(llvm::raw_ostream &os) const;
+
+      protected:
+        static std::atomic< pattern_profile * > current;
+
+      private:
+        mutable std::mutex mutex;
+
+        // Indexed by the pattern and root operation name.
+        std::vector< record > records;
+        llvm::StringMap< std::size_t > record_idx;
+    };
+
+    //
+    // Activates a pattern profile for the lifetime of the pass manager that
+    // owns the instrumentation and reports it when the pipeline finishes:
+    // as a table to `llvm::errs()` or as a JSON file.
+    //
+    // Only one profile is active at a time, pipelines set up while another
+    // profile is active are not profiled.
+    //
+    struct pattern_profiler : mlir::PassInstrumentation, pattern_profile
+    {
+        explicit pattern_profiler(std::optional< std::string > json_path);
+
+        ~pattern_profiler() override;
+
+      private:
+        bool owns_profile = false;
+        std::optional< std::string > json_path;
+    };
+
+} // namespace vast
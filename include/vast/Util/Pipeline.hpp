@@ -5,7 +5,9 @@
 #include "vast/Util/Warnings.hpp"
 
 VAST_RELAX_WARNINGS
+#include <llvm/ADT/DenseMap.h>
 #include <llvm/ADT/DenseSet.h>
+#include <llvm/ADT/SmallVector.h>
 #include <mlir/IR/DialectRegistry.h>
 #include <mlir/Pass/PassManager.h>
 #include <mlir/Pass/PassRegistry.h>
@@ -26,6 +28,8 @@ namespace vast {
     //
     struct pipeline_step;
 
+    struct pipeline_statistics;
+
     using pipeline_step_ptr = std::unique_ptr< pipeline_step >;
 
 
@@ -50,12 +54,27 @@ namespace vast {
             }
 
             seen.insert(id);
+            enclosing_steps[pass.get()] = scheduled_steps;
             base::addNestedPass< parent_t >(std::move(pass));
         }
 
         friend pipeline_t &operator<<(pipeline_t &ppl, pipeline_step_ptr pass);
 
         llvm::DenseSet< pass_id_t > seen;
+
+        //
+        // Names of compound steps that enclose each scheduled pass, used to
+        // attribute pass statistics to pipeline steps.
+        //
+        using step_names = llvm::SmallVector< std::string, 4 >;
+
+        llvm::DenseMap< const mlir::Pass *, step_names > enclosing_steps;
+
+        // Stack of compound steps being currently scheduled.
+        step_names scheduled_steps;
+
+        // Non-owning, the instrumentation is owned by the pass manager.
+        pipeline_statistics *statistics = nullptr;
     };
 
 
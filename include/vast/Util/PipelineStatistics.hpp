@@ -0,0 +1,159 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#pragma once
+
+#include "vast/Util/Warnings.hpp"
+
+VAST_RELAX_WARNINGS
+#include <llvm/ADT/StringMap.h>
+#include <llvm/Support/raw_ostream.h>
+#include <mlir/Pass/PassInstrumentation.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Util/Common.hpp"
+#include "vast/Util/Pipeline.hpp"
+
+#include <chrono>
+#include <mutex>
+#include <optional>
+
+namespace vast {
+
+    //
+    // Pass instrumentation that collects wall time, CPU time, operation counts
+    // and resident memory deltas for every pass and every compound step of
+    // a `pipeline_t`.
+    //
+    // Passes that run on the root operation are measured directly. Passes
+    // nested on functions run in parallel, so their measurements are summed
+    // over all functions: CPU time is taken from the clock of the executing
+    // thread, operations are counted in the function only and resident
+    // memory deltas of concurrent passes overlap. The surrounding pass
+    // adaptor is attributed to the steps of the nested passes it executed.
+    //
+    // Phases of the compilation outside of the pipeline, e.g., code
+    // generation or translation to LLVM IR, are measured by their callers
+    // and reported alongside the steps.
+    //
+    // Statistics are reported when the instrumentation is destroyed together
+    // with its pass manager: as a table to `llvm::errs()` and/or as a JSON
+    // file.
+    //
+    struct pipeline_statistics : mlir::PassInstrumentation
+    {
+        enum class step_kind { pass, nested, compound, phase };
+
+        using clock = std::chrono::steady_clock;
+
+        struct record {
+            std::string name;
+            step_kind kind;
+
+            double wall = 0; // seconds
+            double cpu  = 0; // seconds
+
+            std::optional< std::size_t > ops_before;
+            std::optional< std::size_t > ops_after;
+
+            std::int64_t rss_delta = 0; // bytes
+            unsigned runs = 0;
+
+            // Passes whose time is included in a compound step.
+            llvm::SmallVector< std::string, 4 > passes;
+        };
+
+        // Captures step membership of passes, hence it has to be created after
+        // all steps were scheduled.
+        pipeline_statistics(
+            const pipeline_t &ppl, bool print_table, std::optional< std::string > json_path
+        );
+
+        ~pipeline_statistics() override;
+
+        void runBeforePass(mlir::Pass *pass, operation op) override;
+        void runAfterPass(mlir::Pass *pass, operation op) override;
+        void runAfterPassFailed(mlir::Pass *pass, operation op) override;
+
+        // Named counters reported alongside the pipeline, e.g., cache hits of
+        // the code generation.
+        void add_counter(string_ref name, std::int64_t value);
+
+        struct phase_start {
+            clock::time_point wall;
+            std::chrono::nanoseconds cpu;
+            std::int64_t rss;
+        };
+
+        static phase_start start_phase();
+
+        // Measures a phase that began at `start`, `ops` is the size of its
+        // result if known.
+        static record finish_phase(
+            string_ref name, const phase_start &start, std::optional< std::size_t > ops
+        );
+
+        void add_phase(record phase);
+
+        // Measures a phase that runs in several intervals, e.g., code
+        // generation interleaved with parsing. Intervals may nest, only the
+        // outermost one is measured. Resident memory cannot be attributed to
+        // the intervals, hence it is not measured.
+        struct phase_timer {
+            void start();
+            void stop();
+
+            record finish(string_ref name, std::optional< std::size_t > ops) const;
+
+          private:
+            unsigned depth = 0;
+            clock::time_point wall_start;
+            std::chrono::nanoseconds cpu_start{};
+
+            double wall = 0; // seconds
+            double cpu  = 0; // seconds
+        };
+
+        void print_table(llvm::raw_ostream &os) const;
+        void print_json(llvm::raw_ostream &os) const;
+
+      private:
+        struct snapshot {
+            clock::time_point wall;
+            std::chrono::nanoseconds cpu;
+            std::size_t ops;
+            std::int64_t rss;
+        };
+
+        snapshot take_snapshot(operation root) const;
+        snapshot take_nested_snapshot(operation op) const;
+
+        record &get_record(string_ref name, step_kind kind);
+
+        void finish_root_pass(mlir::Pass *pass, operation root);
+        void finish_nested_pass(mlir::Pass *pass, operation op);
+
+        llvm::DenseMap< const mlir::Pass *, pipeline_t::step_names > enclosing_steps;
+
+        // Records in order of the first execution.
+        std::vector< record > records;
+        llvm::StringMap< std::size_t > record_idx;
+
+        // State of the pass running on the root operation.
+        std::optional< snapshot > root_start;
+        llvm::SmallVector< std::string, 4 > nested_steps;
+        // Nested passes executed by the running pass adaptor with the steps
+        // enclosing them.
+        llvm::SmallVector< std::pair< std::string, std::string >, 4 > nested_members;
+        std::string unit;
+
+        std::vector< std::pair< std::string, std::int64_t > > counters;
+
+        // Nested passes run concurrently.
+        std::mutex nested_mutex;
+        llvm::DenseMap< std::pair< const mlir::Pass *, operation >, snapshot > nested_start;
+
+        bool print;
+        std::optional< std::string > json_path;
+    };
+
+} // namespace vast
@@ -0,0 +1,93 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#pragma once
+
+#include "vast/Util/Warnings.hpp"
+
+VAST_RELAX_WARNINGS
+#include <llvm/ADT/StringMap.h>
+#include <llvm/ADT/SmallVector.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Util/Common.hpp"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace vast::query {
+
+    enum class symbol_kind : unsigned {
+        none     = 0,
+        function = 1 << 0,
+        type     = 1 << 1,
+        record   = 1 << 2,
+        var      = 1 << 3,
+        global   = 1 << 4
+    };
+
+    //
+    // Sidecar index of symbols of a module, so that repeated queries do not
+    // walk the module. Each symbol keeps everything the queries print, i.e.,
+    // the symbol itself and its users, already rendered.
+    //
+    // Symbols and users remember names of their enclosing scopes, i.e., of
+    // symbols of symbol tables they are nested in, to answer scoped queries.
+    //
+    struct symbol_index
+    {
+        using scopes_t = llvm::SmallVector< std::string, 2 >;
+
+        struct user_t
+        {
+            std::string text;
+            scopes_t scopes;
+        };
+
+        struct symbol_t
+        {
+            std::string name;
+            std::string text;
+            unsigned kinds = 0;
+            scopes_t scopes;
+            // Users of MLIR symbols are looked up in the queried scope,
+            // users of VAST symbols are direct users of the symbol op.
+            bool scoped_users = false;
+            std::vector< user_t > users;
+
+            bool has_kind(symbol_kind kind) const {
+                return kinds & static_cast< unsigned >(kind);
+            }
+        };
+
+        // Hash of the input the index was built from, to detect stale
+        // indices.
+        std::string input_hash;
+
+        // In the order of the module walk.
+        std::vector< symbol_t > symbols;
+
+        static symbol_index build(vast_module mod, std::string input_hash);
+
+        // Null if the file does not exist or is not a valid index.
+        static std::optional< symbol_index > load(string_ref path);
+
+        logical_result save(string_ref path) const;
+
+        // Indices of symbols of a given name.
+        llvm::ArrayRef< unsigned > lookup(string_ref name) const;
+
+      private:
+        void rebuild_names();
+
+        llvm::StringMap< llvm::SmallVector< unsigned, 1 > > by_name;
+    };
+
+    static inline bool in_scope(const symbol_index::scopes_t &scopes, string_ref scope) {
+        return llvm::is_contained(scopes, scope);
+    }
+
+    // Hash of an input buffer as stored in the index.
+    std::string input_hash(string_ref contents);
+
+} // namespace vast::query
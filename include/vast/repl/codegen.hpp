@@ -6,8 +6,10 @@
 
 VAST_RELAX_WARNINGS
 #include <clang/AST/ASTContext.h>
+#include <clang/Basic/CodeGenOptions.h>
 #include <clang/Frontend/ASTUnit.h>
-#include <clang/Tooling/Tooling.h>
+#include <clang/Frontend/FrontendOptions.h>
+#include <llvm/ADT/StringMap.h>
 #include <mlir/IR/Builders.h>
 VAST_UNRELAX_WARNINGS
 
@@ -15,11 +17,69 @@ VAST_UNRELAX_WARNINGS
 #include "vast/CodeGen/CodeGen.hpp"
 
 #include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace vast::repl::codegen {
 
-    std::unique_ptr< clang::ASTUnit > ast_from_source(string_ref source);
+    //
+    // Generates the module of a source file incrementally.
+    //
+    // The AST is kept with a precompiled preamble and reparsed only when the
+    // file or any file it includes changes. Functions whose source text did
+    // not change are not generated again, their bodies are cloned from the
+    // previously generated module instead. Any change outside of function bodies regenerates the
+    // whole module.
+    //
+    struct incremental_codegen
+    {
+        incremental_codegen(mcontext_t &mctx, std::filesystem::path source);
+        ~incremental_codegen();
 
-    owning_module_ref emit_module(const std::filesystem::path &source, mcontext_t *ctx);
+        // Whether the source or any file it includes changed since it was
+        // successfully parsed last time.
+        bool is_stale() const;
+
+        // Current AST of the source, reparsed if the source changed. Null if
+        // the source failed to parse.
+        clang::ASTUnit *ast();
+
+        // Generates the module of the current source. Bodies of unchanged
+        // functions are cloned from `previous`, that is expected to be the
+        // module generated by the last call, and is left untouched.
+        owning_module_ref emit(vast_module previous);
+
+        struct fingerprint_t
+        {
+            std::uint64_t text;
+            unsigned line;
+            unsigned column;
+        };
+
+      private:
+        using reuse_t = std::function< bool(hl::FuncOp, const clang::FunctionDecl *) >;
+
+        owning_module_ref generate(const reuse_t &reuse);
+
+        void update_dependencies();
+
+        mcontext_t &mctx;
+        std::filesystem::path source;
+
+        // Files of the last successfully parsed unit and their hashes.
+        std::vector< std::pair< std::string, std::uint64_t > > dependencies;
+
+        std::unique_ptr< clang::ASTUnit > unit;
+
+        // Options the AST unit does not keep, defaults are used as by
+        // `vast-front` without arguments.
+        clang::CodeGenOptions codegen_opts;
+        clang::FrontendOptions frontend_opts;
+
+        // Fingerprints of the source the previous module was generated from.
+        std::optional< std::uint64_t > context;
+        llvm::StringMap< fingerprint_t > functions;
+    };
 
 } // namespace vast::repl::codegen
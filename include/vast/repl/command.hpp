@@ -42,7 +42,9 @@ namespace vast::repl
 
         maybe_memory_buffer get_source_buffer(const state_t &state);
 
-        void check_and_emit_module(state_t &state);
+        // Returns false if the module cannot be loaded or emitted, the error
+        // is reported already.
+        bool check_and_emit_module(state_t &state);
 
         //
         // params
@@ -52,7 +54,7 @@ namespace vast::repl
         struct string_param  { std::string value; };
         struct integer_param { std::uint64_t value; };
 
-        enum class show_kind { source, ast, module, symbols };
+        enum class show_kind { source, ast, module, symbols, tower };
 
         template< typename enum_type >
         enum_type from_string(string_ref token) requires(std::is_same_v< enum_type, show_kind >) {
@@ -60,6 +62,7 @@ namespace vast::repl
             if (token == "ast")     return enum_type::ast;
             if (token == "module")  return enum_type::module;
             if (token == "symbols") return enum_type::symbols;
+            if (token == "tower")   return enum_type::tower;
             VAST_FATAL("uknnown show kind: {0}", token.str());
         }
 
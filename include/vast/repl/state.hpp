@@ -3,6 +3,7 @@
 #pragma once
 
 #include "vast/Tower/Tower.hpp"
+#include "vast/repl/codegen.hpp"
 #include "vast/repl/common.hpp"
 
 #include <filesystem>
@@ -18,6 +19,9 @@ namespace vast::repl {
 
         mcontext_t &ctx;
         std::optional< tw::default_tower > tower;
+
+        // Keeps the AST of a C/C++ source to regenerate the module on change.
+        std::unique_ptr< codegen::incremental_codegen > codegen;
     };
 
 } // namespace vast::repl
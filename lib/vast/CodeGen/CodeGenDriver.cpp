@@ -30,6 +30,9 @@ namespace vast::cg
         if (vargs.has_option(cc::opt::locs_as_meta_ids)) {
             return std::make_unique< id_meta_gen >(&cgctx.actx, &cgctx.mctx);
         }
+        if (vargs.has_option(cc::opt::lazy_locs)) {
+            return std::make_unique< lazy_meta_gen >(&cgctx.actx, &cgctx.mctx);
+        }
         return std::make_unique< default_meta_gen >(&cgctx.actx, &cgctx.mctx);
     }
 
@@ -181,6 +184,10 @@ namespace vast::cg
             return fn;
         }
 
+        if (skip_body && skip_body(fn, function_decl)) {
+            return fn;
+        }
+
         // TODO setGVProperties
         // TODO MaubeHandleStaticInExternC
         // TODO maybeSetTrivialComdat
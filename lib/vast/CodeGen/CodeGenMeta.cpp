@@ -0,0 +1,31 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#include "vast/CodeGen/CodeGenMeta.hpp"
+
+VAST_RELAX_WARNINGS
+#include <mlir/IR/AttrTypeSubElements.h>
+VAST_UNRELAX_WARNINGS
+
+namespace vast::cg
+{
+    void expand_lazy_locations(operation root, const clang::SourceManager &sm) {
+        file_location_cache cache(sm, root->getContext());
+
+        // The replacer memoizes replaced attributes, hence each distinct
+        // source location is expanded once.
+        mlir::AttrTypeReplacer replacer;
+        replacer.addReplacement([&] (mlir::OpaqueLoc loc) -> std::optional< mlir::Attribute > {
+            if (loc.getUnderlyingTypeID() != lazy_location_id()) {
+                return std::nullopt;
+            }
+
+            auto raw = static_cast< clang::SourceLocation::UIntTy >(loc.getUnderlyingLocation());
+            return mlir::LocationAttr(cache.get(clang::SourceLocation::getFromRawEncoding(raw)));
+        });
+
+        replacer.recursivelyReplaceElementsIn(
+            root, /* attrs */ true, /* locs */ true, /* types */ false
+        );
+    }
+
+} // namespace vast::cg
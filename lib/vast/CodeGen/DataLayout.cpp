@@ -5,14 +5,7 @@
 namespace vast::hl
 {
     void emit_data_layout(mcontext_t &ctx, owning_module_ref &mod, const dl::DataLayoutBlueprint &dl) {
-        std::vector< mlir::DataLayoutEntryInterface > entries;
-        for (const auto &[_, e] : dl.entries) {
-            entries.push_back(e.wrap(ctx));
-        }
-
-        mod.get()->setAttr(
-            mlir::DLTIDialect::kDataLayoutAttrName, mlir::DataLayoutSpecAttr::get(&ctx, entries)
-        );
+        mod.get()->setAttr(core::CoreDialect::getDataLayoutAttrName(), dl.wrap(ctx));
     }
 
 } // namespace vast::hl
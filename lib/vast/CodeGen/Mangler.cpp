@@ -9,6 +9,15 @@ namespace vast::cg
     ) {
         auto canonical = decl.getCanonicalDecl();
 
+        // Fast path for already mangled declarations, the name is interned in
+        // `manglings`.
+        if (auto it = mangled_decl_names.find(canonical); it != mangled_decl_names.end()) {
+            ++hits;
+            return it->second;
+        }
+
+        ++misses;
+
         // Some ABIs don't have constructor variants. Make sure that base and complete
         // constructors get mangled the same.
         if (const auto *ctor = clang::dyn_cast< clang::CXXConstructorDecl >(canonical.getDecl())) {
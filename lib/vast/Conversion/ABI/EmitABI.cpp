@@ -13,6 +13,9 @@ VAST_RELAX_WARNINGS
 
 #include <mlir/Rewrite/PatternApplicator.h>
 
+#include <mlir/IR/Threading.h>
+#include <llvm/ADT/DenseMap.h>
+
 #include <llvm/ADT/APFloat.h>
 VAST_UNRELAX_WARNINGS
 
@@ -56,26 +59,47 @@ namespace vast
         return out;
     }
 
+    //
+    // Classification is memoized per distinct function type, functions refer
+    // to it by their symbol. The cache is not modified once collected, so it
+    // can be shared by functions rewritten in parallel.
+    //
     template< typename Op >
-    using abi_info_map_t = std::unordered_map< std::string, abi::func_info< Op > >;
-
-    template< typename R, typename RootOp, typename DL >
-    auto collect_abi_info(RootOp root_op, const DL &dl)
-        -> abi_info_map_t< R >
+    struct abi_info_cache
     {
-        abi_info_map_t< R > out;
-        auto gather = [&](R op, const mlir::WalkStage &)
+        using info_t = abi::func_info< Op >;
+
+        abi_info_cache(const mlir::DataLayout &dl, const hl::record_index &records)
+            : classifications(dl, records)
+        {}
+
+        const info_t *lookup(mlir::StringAttr symbol) const
         {
-            auto name = op.getName();
-            out.emplace( name.str(), abi::make_x86_64(op, dl) );
+            return by_symbol.lookup(symbol);
+        }
+
+        abi::x86_64_cache< Op > classifications;
+        llvm::DenseMap< mlir::StringAttr, const info_t * > by_symbol;
+    };
 
-            return mlir::WalkResult::advance();
+    template< typename R, typename RootOp >
+    auto collect_abi_info(RootOp root_op, const mlir::DataLayout &dl,
+                          const hl::record_index &records)
+        -> abi_info_cache< R >
+    {
+        abi_info_cache< R > out(dl, records);
+        auto gather = [&](R op)
+        {
+            out.by_symbol.try_emplace(op.getSymNameAttr(), &out.classifications.get(op));
         };
 
         root_op->walk(gather);
         return out;
     }
 
+    // TODO(conv:abi): We should always emit main with a fixed type.
+    static bool keeps_signature(hl::FuncOp op) { return op.getName() == "main"; }
+
     // TODO(conv:abi): Remove as we most likely do not need this.
     struct TypeConverter : conv::tc::mixins< TypeConverter >,
                            conv::tc::identity_type_converter
@@ -196,25 +220,24 @@ namespace vast
 
         };
 
+        // Unlike the other wrappers, functions are not rewritten by a dialect
+        // conversion, so that their bodies can be moved instead of cloned.
         template< typename op_t >
-        struct abi_transform : match_and_rewrite_state_capture< op_t >,
-                               abi_info_utils< abi_transform< op_t > >
+        struct abi_transform : abi_info_utils< abi_transform< op_t > >
         {
-            using state_t = match_and_rewrite_state_capture< op_t >;
             using abi_utils = abi_info_utils< abi_transform< op_t > >;
             using abi_info_t = typename abi_utils::abi_info_t;
 
-            using state_t::op;
-            using state_t::operands;
-            using state_t::rewriter;
+            op_t op;
+            mlir::RewriterBase &rewriter;
 
             const abi_info_t &abi_info;
 
             using materialized_args_t = std::vector< mlir::Value >;
             using mapped_arg_t = std::tuple< mlir::Type, materialized_args_t >;
 
-            abi_transform(state_t state, const abi_info_t &abi_info)
-                : state_t(std::move(state)), abi_info(abi_info)
+            abi_transform(op_t op, mlir::RewriterBase &rewriter, const abi_info_t &abi_info)
+                : op(op), rewriter(rewriter), abi_info(abi_info)
             {}
 
             using types_t = std::vector< mlir::Type >;
@@ -378,7 +401,7 @@ namespace vast
             void get_body(abi::FuncOp func, const auto &arg_mapping)
             {
 
-                rewriter.cloneRegionBefore(op.getBody(), func.getBody(),
+                rewriter.inlineRegionBefore(op.getBody(), func.getBody(),
                                             func.getBody().end());
 
                 auto entry = &*func.getBody().begin();
@@ -680,95 +703,62 @@ namespace vast
 
         };
 
-        template< typename Op >
-        struct func_type : mlir::OpConversionPattern< Op >
-        {
-            using Base = mlir::OpConversionPattern< Op >;
-
-            TypeConverter &tc;
-            const abi_info_map_t< hl::FuncOp > &abi_info_map;
-
-            func_type(TypeConverter &tc,
-                      const abi_info_map_t< hl::FuncOp > &abi_info_map,
-                      mcontext_t &mctx)
-                : Base(tc, &mctx), tc(tc), abi_info_map(abi_info_map)
-            {}
-
-            mlir::LogicalResult matchAndRewrite(
-                    Op op, typename Op::Adaptor ops,
-                    conversion_rewriter &rewriter) const override
-            {
-                auto abi_map_it = abi_info_map.find(op.getName().str());
-                if (abi_map_it == abi_info_map.end())
-                    return mlir::failure();
-
-                const auto &abi_info = abi_map_it->second;
-                abi_transform< Op >({ op, ops, rewriter }, abi_info).make();
-                rewriter.eraseOp(op);
-                return mlir::success();
-            }
-        };
-
         struct call_op : mlir::OpConversionPattern< hl::CallOp >
         {
             using Base = mlir::OpConversionPattern< hl::CallOp >;
             using Op = hl::CallOp;
 
             TypeConverter &tc;
-            const abi_info_map_t< hl::FuncOp > &abi_info_map;
+            const abi_info_cache< hl::FuncOp > &abi_info;
 
-            call_op(TypeConverter &tc, const abi_info_map_t< hl::FuncOp > &abi_info_map,
+            call_op(TypeConverter &tc, const abi_info_cache< hl::FuncOp > &abi_info,
                     mcontext_t &mctx)
-                : Base(tc, &mctx), tc(tc), abi_info_map(abi_info_map)
+                : Base(tc, &mctx), tc(tc), abi_info(abi_info)
             {}
 
             mlir::LogicalResult matchAndRewrite(
                     Op op, typename Op::Adaptor ops,
                     conversion_rewriter &rewriter) const override
             {
-                auto abi_map_it = abi_info_map.find(op.getCallee().str());
-                if (abi_map_it == abi_info_map.end())
+                auto info = abi_info.lookup(op.getCalleeAttr().getAttr());
+                if (!info)
                     return mlir::failure();
 
-                const auto &abi_info = abi_map_it->second;
-                auto call = call_wrapper< Op >({op, ops, rewriter}, abi_info).make();
+                auto call = call_wrapper< Op >({op, ops, rewriter}, *info).make();
                 rewriter.replaceOp(op, call);
                 return mlir::success();
             }
         };
 
+        // Returns are rewritten while still nested in `hl.func`, the function
+        // itself is converted once its body is done.
         struct return_op : mlir::OpConversionPattern< hl::ReturnOp >
         {
             using Base = mlir::OpConversionPattern< hl::ReturnOp >;
             using Op = hl::ReturnOp;
 
             TypeConverter &tc;
-            const abi_info_map_t< hl::FuncOp > &abi_info_map;
+            const abi_info_cache< hl::FuncOp > &abi_info;
 
             return_op(TypeConverter &tc,
-                      const abi_info_map_t< hl::FuncOp > &abi_info_map,
+                      const abi_info_cache< hl::FuncOp > &abi_info,
                       mcontext_t &mctx)
-                : Base(tc, &mctx), tc(tc), abi_info_map(abi_info_map)
+                : Base(tc, &mctx), tc(tc), abi_info(abi_info)
             {}
 
             mlir::LogicalResult matchAndRewrite(
                     Op op, typename Op::Adaptor ops,
                     conversion_rewriter &rewriter) const override
             {
-                auto func = op->getParentOfType< abi::FuncOp >();
-                if (!func)
+                auto func = op->getParentOfType< hl::FuncOp >();
+                if (!func || keeps_signature(func))
                     return mlir::failure();
 
-                auto name = func.getName();
-                if (!name.consume_front(conv::abi::abi_func_name_prefix))
+                auto info = abi_info.lookup(func.getSymNameAttr());
+                if (!info)
                     return mlir::failure();
 
-                auto abi_map_it = abi_info_map.find(name.str());
-                if (abi_map_it == abi_info_map.end())
-                    return mlir::failure();
-
-                const auto &abi_info = abi_map_it->second;
-                return_wrapper< Op >({op, ops, rewriter}, abi_info).make();
+                return_wrapper< Op >({op, ops, rewriter}, *info).make();
 
                 rewriter.eraseOp(op);
                 return mlir::success();
@@ -778,13 +768,17 @@ namespace vast
     } // namespace
 
 
+    //
+    // Calls and returns are rewritten by a single conversion of each function
+    // body, bodies are independent of each other and hence are processed in
+    // parallel. Functions are converted to `abi.func` afterwards, which
+    // modifies the module and therefore runs sequentially.
+    //
     struct EmitABI : EmitABIBase< EmitABI >
     {
-        using target_t = mlir::ConversionTarget;
-        using patterns_t = mlir::RewritePatternSet;
-        using phase_t = std::tuple< target_t, patterns_t >;
+        using abi_info_t = abi_info_cache< hl::FuncOp >;
 
-        phase_t first_phase(auto &tc, const auto &abi_info_map)
+        mlir::ConversionTarget body_target()
         {
             auto &mctx = this->getContext();
 
@@ -792,47 +786,12 @@ namespace vast
             target.markUnknownOpDynamicallyLegal([](auto) { return true; });
             target.addIllegalOp< hl::CallOp >();
 
-            mlir::RewritePatternSet patterns(&mctx);
-            patterns.add< call_op >(tc, abi_info_map, mctx);
-
-            return { std::move(target), std::move(patterns) };
-        }
-
-        phase_t second_phase(auto &tc, const auto &abi_info_map)
-        {
-
-            auto &mctx = this->getContext();
-
-            mlir::ConversionTarget target(mctx);
-            target.markUnknownOpDynamicallyLegal([](auto) { return true; });
-
-            auto should_transform = [&](hl::FuncOp op)
-            {
-                // TODO(conv:abi): We should always emit main with a fixed type.
-                return op.getName() == "main";
-            };
-
-            target.addDynamicallyLegalOp< hl::FuncOp >(should_transform);
-
-            mlir::RewritePatternSet patterns(&mctx);
-            patterns.add< func_type< hl::FuncOp > >(tc, abi_info_map, mctx);
-
-            return { std::move(target), std::move(patterns) };
-        }
-
-        phase_t third_phase(auto &tc, const auto &abi_info_map)
-        {
-            auto &mctx = this->getContext();
-
-            mlir::ConversionTarget target(mctx);
-            target.markUnknownOpDynamicallyLegal([](auto) { return true; });
-
             // Plan is to still leave `hl.return` but it should return values
             // yielded by `abi.epilogue`.
             auto is_return_legal = [&](hl::ReturnOp op)
             {
-                auto func = op->getParentOfType< abi::FuncOp >();
-                if (!func)
+                auto func = op->getParentOfType< hl::FuncOp >();
+                if (!func || keeps_signature(func))
                     return true;
 
                 for (auto val : op.getResult())
@@ -842,17 +801,29 @@ namespace vast
             };
 
             target.addDynamicallyLegalOp< hl::ReturnOp >(is_return_legal);
+            return target;
+        }
 
-            mlir::RewritePatternSet patterns(&mctx);
-            patterns.add< return_op >(tc, abi_info_map, mctx);
+        mlir::FrozenRewritePatternSet body_patterns(auto &tc, const abi_info_t &abi_info)
+        {
+            auto &mctx = this->getContext();
 
-            return { std::move(target), std::move(patterns) };
+            mlir::RewritePatternSet patterns(&mctx);
+            patterns.add< call_op, return_op >(tc, abi_info, mctx);
+            return mlir::FrozenRewritePatternSet(std::move(patterns));
         }
 
-        mlir::LogicalResult run(phase_t phase)
+        mlir::LogicalResult convert_function(hl::FuncOp op, const abi_info_t &abi_info)
         {
-            auto [trg, patterns] = std::move(phase);
-            return mlir::applyPartialConversion(this->getOperation(), trg, std::move(patterns));
+            auto info = abi_info.lookup(op.getSymNameAttr());
+            if (!info)
+                return mlir::failure();
+
+            mlir::IRRewriter rewriter(&this->getContext());
+            rewriter.setInsertionPoint(op);
+            abi_transform< hl::FuncOp >(op, rewriter, *info).make();
+            rewriter.eraseOp(op);
+            return mlir::success();
         }
 
         void runOnOperation() override
@@ -861,18 +832,46 @@ namespace vast
             mlir::ModuleOp op = this->getOperation();
 
             const auto &dl_analysis = this->getAnalysis< mlir::DataLayoutAnalysis >();
+            const auto &records = this->getAnalysis< hl::record_index >();
             auto tc = TypeConverter(dl_analysis.getAtOrAbove(op), mctx);
-            auto abi_info_map = collect_abi_info< hl::FuncOp >(
-                    op, dl_analysis.getAtOrAbove(op));
+            auto abi_info = collect_abi_info< hl::FuncOp >(
+                    op, dl_analysis.getAtOrAbove(op), records);
 
-            if (mlir::failed(run(first_phase(tc, abi_info_map))))
-                return signalPassFailure();
+            std::vector< hl::FuncOp > functions;
+            // Calls outside of functions, e.g., in initializers of globals.
+            std::vector< operation > other_calls;
+            op->walk< mlir::WalkOrder::PreOrder >([&](operation nested)
+            {
+                if (auto fn = mlir::dyn_cast< hl::FuncOp >(nested)) {
+                    functions.push_back(fn);
+                    return mlir::WalkResult::skip();
+                }
+                if (mlir::isa< hl::CallOp >(nested))
+                    other_calls.push_back(nested);
+                return mlir::WalkResult::advance();
+            });
+
+            auto target = body_target();
+            auto patterns = body_patterns(tc, abi_info);
 
-            if (mlir::failed(run(second_phase(tc, abi_info_map))))
+            auto convert_body = [&](hl::FuncOp fn)
+            {
+                return mlir::applyPartialConversion(fn, target, patterns);
+            };
+
+            if (mlir::failed(mlir::failableParallelForEach(&mctx, functions, convert_body)))
                 return signalPassFailure();
 
-            if (mlir::failed(run(third_phase(tc, abi_info_map))))
+            if (mlir::failed(mlir::applyPartialConversion(other_calls, target, patterns)))
                 return signalPassFailure();
+
+            for (auto fn : functions)
+            {
+                if (keeps_signature(fn))
+                    continue;
+                if (mlir::failed(convert_function(fn, abi_info)))
+                    return signalPassFailure();
+            }
         }
     };
 
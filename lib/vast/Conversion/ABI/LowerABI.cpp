@@ -24,6 +24,7 @@ VAST_UNRELAX_WARNINGS
 #include "vast/Dialect/HighLevel/HighLevelTypes.hpp"
 #include "vast/Dialect/HighLevel/HighLevelOps.hpp"
 #include "vast/Dialect/HighLevel/HighLevelUtils.hpp"
+#include "vast/Dialect/HighLevel/RecordIndex.hpp"
 
 #include "vast/Dialect/LowLevel/LowLevelOps.hpp"
 
@@ -85,11 +86,13 @@ namespace vast
             using op_t = Op;
 
             const mlir::DataLayout &dl;
+            const hl::record_index &records;
 
             template< typename ... Args >
-            abi_pattern_base(const mlir::DataLayout &dl, Args && ... args)
+            abi_pattern_base(const mlir::DataLayout &dl, const hl::record_index &records,
+                             Args && ... args)
                 : base(std::forward< Args >(args) ...),
-                  dl(dl)
+                  dl(dl), records(records)
             {}
 
             using state_capture = match_and_rewrite_state_capture< op_t >;
@@ -648,18 +651,19 @@ namespace vast
             return target;
         }
 
-        void add_patterns(auto &config, const auto &dl)
+        void add_patterns(auto &config, const auto &dl, const auto &records)
         {
-            config.patterns.template add< pattern::prologue >(dl, config.getContext());
-            config.patterns.template add< pattern::epilogue >(dl, config.getContext());
+            auto mctx = config.getContext();
+            config.patterns.template add< pattern::prologue >(dl, records, mctx);
+            config.patterns.template add< pattern::epilogue >(dl, records, mctx);
 
-            config.patterns.template add< pattern::call_args >(dl, config.getContext());
-            config.patterns.template add< pattern::call_rets >(dl, config.getContext());
+            config.patterns.template add< pattern::call_args >(dl, records, mctx);
+            config.patterns.template add< pattern::call_rets >(dl, records, mctx);
 
-            config.patterns.template add< pattern::call >(config.getContext());
-            config.patterns.template add< pattern::call_exec >(config.getContext());
+            config.patterns.template add< pattern::call >(mctx);
+            config.patterns.template add< pattern::call_exec >(mctx);
 
-            config.patterns.template add< pattern::function >(config.getContext());
+            config.patterns.template add< pattern::function >(mctx);
 
             config.target.template addIllegalOp< abi::PrologueOp >();
             config.target.template addIllegalOp< abi::EpilogueOp >();
@@ -688,11 +692,16 @@ namespace vast
             const auto &dl_analysis = this->template getAnalysis< mlir::DataLayoutAnalysis >();
             auto dl = dl_analysis.getAtOrAbove(op);
 
-            add_patterns(config, dl);
+            const auto &records = this->template getAnalysis< hl::record_index >();
+
+            add_patterns(config, dl, records);
 
             if (mlir::failed(base::apply_conversions(std::move(config))))
                 return signalPassFailure();
 
+            // Functions are rebuilt by moving their regions, record definitions stay intact.
+            this->template markAnalysesPreserved< hl::record_index >();
+
             this->after_operation();
         }
 
@@ -635,6 +635,16 @@ namespace vast::conv::irstollvm
                 return rewriter.getIntegerAttr(target_type, coerced);
             }
 
+            // Elements are already stored as builtin integers or floats of
+            // the width of the target element type.
+            if (auto dense_attr = attr.template dyn_cast< core::DenseElementsAttr >())
+            {
+                auto array = mlir::dyn_cast< mlir::LLVM::LLVMArrayType >(target_type);
+                if (!array || array.getNumElements() != dense_attr.getElements().getNumElements())
+                    return {};
+                return dense_attr.getElements();
+            }
+
             VAST_UNREACHABLE("Trying to convert attr that is not supported, {0} in op {1}",
                              attr, op);
             return {};
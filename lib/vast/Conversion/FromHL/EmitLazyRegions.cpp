@@ -141,6 +141,10 @@ namespace vast
                 bin_lop_conversions
             >(config);
         }
+
+        void after_operation() override {
+            this->template markAnalysesPreserved< hl::record_index >();
+        }
     };
 
     std::unique_ptr< mlir::Pass > createHLEmitLazyRegionsPass() {
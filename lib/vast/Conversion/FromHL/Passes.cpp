@@ -8,12 +8,20 @@ VAST_RELAX_WARNINGS
 VAST_UNRELAX_WARNINGS
 
 #include "vast/Conversion/Passes.hpp"
+#include "vast/Dialect/LowLevel/LowLevelOps.hpp"
 
 namespace vast::conv::pipeline {
 
-    pipeline_step_ptr hl_to_ll_cf() {
+    pipeline_step_ptr hl_to_ll_func() {
         // TODO add dependencies
-        return pass(createHLToLLCFPass);
+        return pass(createHLToLLFuncPass);
+    }
+
+    // Control flow and local variables do not leave function bodies, hence
+    // these conversions are scheduled on each function in parallel.
+    pipeline_step_ptr hl_to_ll_cf() {
+        return nested< ll::FuncOp >(createHLToLLCFPass)
+            .depends_on(hl_to_ll_func);
     }
 
     pipeline_step_ptr hl_to_ll_geps() {
@@ -22,8 +30,8 @@ namespace vast::conv::pipeline {
     }
 
     pipeline_step_ptr hl_to_ll_vars() {
-        // TODO add dependencies
-        return pass(createHLToLLVarsPass);
+        return nested< ll::FuncOp >(createHLToLLVarsPass)
+            .depends_on(hl_to_ll_func);
     }
 
     pipeline_step_ptr lazy_regions() {
@@ -31,11 +39,6 @@ namespace vast::conv::pipeline {
         return pass(createHLEmitLazyRegionsPass);
     }
 
-    pipeline_step_ptr hl_to_ll_func() {
-        // TODO add dependencies
-        return pass(createHLToLLFuncPass);
-    }
-
     pipeline_step_ptr to_ll() {
         return compose( "to-ll",
             hl_to_ll_func,
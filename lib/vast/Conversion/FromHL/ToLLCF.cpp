@@ -498,7 +498,7 @@ namespace vast::conv
                 // We really don't care if anything ws remove or not.
                 std::ignore = mlir::eraseUnreachableBlocks(rewriter, scope.getBody());
             };
-            this->getOperation().walk(clean_scopes);
+            this->getOperation()->walk(clean_scopes);
 
             auto clean_functions = [&](hl::FuncOp fn)
             {
@@ -506,7 +506,7 @@ namespace vast::conv
                 // We really don't care if anything ws remove or not.
                 std::ignore = mlir::eraseUnreachableBlocks(rewriter, fn.getBody());
             };
-            this->getOperation().walk(clean_functions);
+            this->getOperation()->walk(clean_functions);
         }
     };
 
@@ -6,6 +6,7 @@
 #include "vast/Conversion/Common/Passes.hpp"
 #include "vast/Conversion/Common/Patterns.hpp"
 
+#include "vast/Dialect/HighLevel/RecordIndex.hpp"
 #include "vast/Dialect/LowLevel/LowLevelOps.hpp"
 
 #include "vast/Util/Common.hpp"
@@ -65,6 +66,11 @@ namespace vast::conv::hltollfunc
                 util::type_list< pattern::func_op>
             >(config);
         }
+
+        // Function bodies are moved, not cloned, so record definitions stay valid.
+        void after_operation() override {
+            this->template markAnalysesPreserved< hl::record_index >();
+        }
     };
 } // namespace vast::conv::hltollfunc
 
@@ -13,8 +13,11 @@ VAST_UNRELAX_WARNINGS
 
 #include "vast/Dialect/HighLevel/HighLevelOps.hpp"
 #include "vast/Dialect/HighLevel/HighLevelUtils.hpp"
+#include "vast/Dialect/HighLevel/RecordIndex.hpp"
 #include "vast/Dialect/LowLevel/LowLevelOps.hpp"
 
+#include "vast/Conversion/Common/RunBound.hpp"
+
 #include "vast/Util/DialectConversion.hpp"
 #include "vast/Util/Symbols.hpp"
 
@@ -24,34 +27,35 @@ namespace vast {
         {
             using op_t = hl::RecordMemberOp;
             using base = mlir::OpConversionPattern< op_t >;
+
+            // Bound by each run of the pass.
+            run_bound< hl::record_index > records;
+
             using base::base;
 
             logical_result matchAndRewrite(
                 op_t op, typename op_t::Adaptor ops, conversion_rewriter &rewriter
             ) const override {
-                auto parent_type = ops.getRecord().getType();
-
-                auto mod = op->getParentOfType< vast_module >();
-                if (!mod) {
+                auto info = records->lookup(ops.getRecord().getType());
+                if (!info) {
                     return mlir::failure();
                 }
 
-                auto def = hl::definition_of(parent_type, mod);
-                if (auto struct_decl = mlir::dyn_cast_or_null< hl::StructDeclOp >(*def)) {
-                    return lower(op, ops, rewriter, struct_decl);
+                if (mlir::isa< hl::StructDeclOp >(*info->decl)) {
+                    return lower_struct(op, ops, rewriter, *info);
                 }
-                if (auto union_decl = mlir::dyn_cast_or_null< hl::UnionDeclOp >(*def)) {
-                    return lower(op, ops, rewriter, union_decl);
+                if (mlir::isa< hl::UnionDeclOp >(*info->decl)) {
+                    return lower_union(op, ops, rewriter);
                 }
 
                 return mlir::failure();
             }
 
-            logical_result lower(
+            logical_result lower_struct(
                 op_t op, typename op_t::Adaptor ops, conversion_rewriter &rewriter,
-                hl::StructDeclOp struct_decl
+                const hl::record_index::record_info &info
             ) const {
-                auto idx = hl::field_idx(op.getName(), struct_decl);
+                auto idx = info.field_idx(op.getName());
                 if (!idx) {
                     return mlir::failure();
                 }
@@ -59,9 +63,8 @@ namespace vast {
                 return replace(op, ops, rewriter, *idx);
             }
 
-            logical_result lower(
-                op_t op, typename op_t::Adaptor ops, conversion_rewriter &rewriter,
-                hl::UnionDeclOp union_decl
+            logical_result lower_union(
+                op_t op, typename op_t::Adaptor ops, conversion_rewriter &rewriter
             ) const {
                 // After lowered, union will only have one member.
                 return replace(op, ops, rewriter, 0);
@@ -83,22 +86,35 @@ namespace vast {
 
     struct HLToLLGEPsPass : HLToLLGEPsBase< HLToLLGEPsPass >
     {
-        void runOnOperation() override {
-            auto op    = this->getOperation();
-            auto &mctx = this->getContext();
-
-            mlir::ConversionTarget trg(mctx);
-            trg.markUnknownOpDynamicallyLegal([](auto) { return true; });
-            trg.addIllegalOp< hl::RecordMemberOp >();
+        logical_result initialize(mcontext_t *mctx) override {
+            auto trg = std::make_shared< mlir::ConversionTarget >(*mctx);
+            trg->markUnknownOpDynamicallyLegal([](auto) { return true; });
+            trg->addIllegalOp< hl::RecordMemberOp >();
+            target = std::move(trg);
+
+            mlir::RewritePatternSet set(mctx);
+            set.add< record_member_op >(mctx);
+            patterns = mlir::FrozenRewritePatternSet(std::move(set));
+            return mlir::success();
+        }
 
-            mlir::RewritePatternSet patterns(&mctx);
+        void runOnOperation() override {
+            auto op = this->getOperation();
 
-            patterns.add< record_member_op >(&mctx);
+            auto records = run_bound< hl::record_index >::bind(
+                this->getAnalysis< hl::record_index >()
+            );
 
-            if (mlir::failed(mlir::applyPartialConversion(op, trg, std::move(patterns)))) {
+            if (mlir::failed(mlir::applyPartialConversion(op, *target, patterns))) {
                 return signalPassFailure();
             }
+
+            // Only `hl.member` operations are replaced, record definitions are untouched.
+            this->markAnalysesPreserved< hl::record_index >();
         }
+
+        std::shared_ptr< const mlir::ConversionTarget > target;
+        mlir::FrozenRewritePatternSet patterns;
     };
 } // namespace vast
 
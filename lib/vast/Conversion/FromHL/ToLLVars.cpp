@@ -14,6 +14,7 @@ VAST_UNRELAX_WARNINGS
 #include "PassesDetails.hpp"
 
 #include "vast/Dialect/HighLevel/HighLevelOps.hpp"
+#include "vast/Dialect/HighLevel/RecordIndex.hpp"
 #include "vast/Dialect/LowLevel/LowLevelOps.hpp"
 
 #include "vast/Util/Common.hpp"
@@ -110,33 +111,45 @@ namespace vast
 
     struct HLToLLVarsPass : HLToLLVarsBase< HLToLLVarsPass >
     {
-        void runOnOperation() override
+        logical_result initialize(mcontext_t *mctx) override
         {
-            auto op = this->getOperation();
-            auto &mctx = this->getContext();
-
-            mlir::ConversionTarget trg(mctx);
-            trg.markUnknownOpDynamicallyLegal( [](auto) { return true; } );
-            trg.addDynamicallyLegalOp< hl::VarDeclOp >([&](hl::VarDeclOp op)
+            auto trg = std::make_shared< mlir::ConversionTarget >(*mctx);
+            trg->markUnknownOpDynamicallyLegal( [](auto) { return true; } );
+            trg->addDynamicallyLegalOp< hl::VarDeclOp >([](hl::VarDeclOp op)
             {
                 // TODO(conv): `!ast_node->isLocalVarDeclOrParam()` should maybe be ported
                 //             to the mlir op?
                 return mlir::isa< vast_module >(op->getParentOp());
             });
+            target = std::move(trg);
 
-            const auto &dl_analysis = this->getAnalysis< mlir::DataLayoutAnalysis >();
-
-            mlir::LowerToLLVMOptions llvm_options(&mctx);
+            // The converter is shared by all runs, each run binds the data
+            // layout of its module.
+            mlir::LowerToLLVMOptions llvm_options(mctx);
             llvm_options.useBarePtrCallConv = true;
-            conv::tc::LLVMTypeConverter type_converter(&mctx, llvm_options, &dl_analysis);
+            type_converter = std::make_shared< conv::tc::LLVMTypeConverter >(mctx, llvm_options);
 
-            mlir::RewritePatternSet patterns(&mctx);
+            mlir::RewritePatternSet set(mctx);
+            set.add< pattern::vardecl_op >(*type_converter);
+            patterns = mlir::FrozenRewritePatternSet(std::move(set));
+            return mlir::success();
+        }
 
-            patterns.add< pattern::vardecl_op >(type_converter);
+        void runOnOperation() override
+        {
+            auto bound = type_converter->bind_data_layout(
+                this->getAnalysis< mlir::DataLayoutAnalysis >()
+            );
 
-            if (mlir::failed(mlir::applyPartialConversion(op, trg, std::move(patterns))))
+            if (mlir::failed(mlir::applyPartialConversion(getOperation(), *target, patterns)))
                 return signalPassFailure();
+
+            this->markAnalysesPreserved< hl::record_index >();
         }
+
+        std::shared_ptr< conv::tc::LLVMTypeConverter > type_converter;
+        std::shared_ptr< const mlir::ConversionTarget > target;
+        mlir::FrozenRewritePatternSet patterns;
     };
 } // namespace vast
 
@@ -2,6 +2,7 @@
 
 #include "vast/Dialect/ABI/ABIDialect.hpp"
 #include "vast/Dialect/ABI/ABIOps.hpp"
+#include "vast/Dialect/Bytecode.hpp"
 
 namespace vast::abi
 {
@@ -11,6 +12,8 @@ namespace vast::abi
             #define GET_OP_LIST
             #include "vast/Dialect/ABI/ABI.cpp.inc"
         >();
+
+        addInterfaces< versioned_bytecode_interface< 1 > >();
     }
 } // namespace vast::abi
 
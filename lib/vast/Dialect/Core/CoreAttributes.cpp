@@ -4,8 +4,10 @@
 #include "vast/Dialect/Core/CoreOps.hpp"
 #include "vast/Dialect/Core/CoreTypes.hpp"
 #include "vast/Dialect/Core/CoreAttributes.hpp"
+#include "vast/Util/DataLayout.hpp"
 
 VAST_RELAX_WARNINGS
+#include <llvm/ADT/DenseSet.h>
 #include <llvm/ADT/TypeSwitch.h>
 #include <mlir/IR/Builders.h>
 #include <mlir/IR/OpImplementation.h>
@@ -61,6 +63,64 @@ namespace mlir {
 
 } // namespace mlir
 
+namespace vast::core::detail
+{
+    struct DataLayoutTableAttrStorage : mlir::AttributeStorage
+    {
+        using KeyTy = std::tuple< mlir::DataLayoutSpecAttr >;
+
+        explicit DataLayoutTableAttrStorage(mlir::DataLayoutSpecAttr spec) : spec(spec)
+        {
+            llvm::DenseSet< mlir::TypeID > mixed;
+            for (auto entry : spec.getEntries()) {
+                auto type = mlir::dyn_cast< mlir_type >(entry.getKey());
+                if (!type) {
+                    continue;
+                }
+
+                // Only entries in the VAST encoding can be answered by the table.
+                if (!mlir::isa< mlir::DictionaryAttr >(entry.getValue())) {
+                    mixed.insert(type.getTypeID());
+                    continue;
+                }
+
+                auto [it, inserted] = entries.try_emplace(type, dl::DLEntry(entry));
+                VAST_CHECK(inserted || it->second == dl::DLEntry(entry),
+                    "Inconsistent data layout entries of type {0}", type
+                );
+                representatives.try_emplace(type.getTypeID(), type);
+            }
+
+            for (auto id : mixed) {
+                representatives.erase(id);
+            }
+        }
+
+        KeyTy getAsKey() const { return KeyTy(spec); }
+
+        bool operator==(const KeyTy &key) const { return key == getAsKey(); }
+
+        static llvm::hash_code hashKey(const KeyTy &key) {
+            return llvm::hash_value(std::get< 0 >(key));
+        }
+
+        static DataLayoutTableAttrStorage *construct(
+            mlir::AttributeStorageAllocator &allocator, const KeyTy &key
+        ) {
+            return new (allocator.allocate< DataLayoutTableAttrStorage >())
+                DataLayoutTableAttrStorage(std::get< 0 >(key));
+        }
+
+        mlir::DataLayoutSpecAttr spec;
+
+        llvm::DenseMap< mlir_type, dl::DLEntry > entries;
+        // Some type of each kind answered by the table, keys the entry that
+        // refers the queries to the table.
+        llvm::DenseMap< mlir::TypeID, mlir_type > representatives;
+    };
+
+} // namespace vast::core::detail
+
 #define GET_ATTRDEF_CLASSES
 #include "vast/Dialect/Core/CoreAttributes.cpp.inc"
 
@@ -69,6 +129,50 @@ namespace vast::core
     using DialectParser = mlir::AsmParser;
     using DialectPrinter = mlir::AsmPrinter;
 
+    const dl::DLEntry *DataLayoutTableAttr::lookup(mlir_type type) const
+    {
+        const auto &entries = getImpl()->entries;
+        if (auto it = entries.find(type); it != entries.end()) {
+            return &it->second;
+        }
+        return nullptr;
+    }
+
+    mlir::DataLayoutEntryList DataLayoutTableAttr::getSpecForType(mlir::TypeID type) const
+    {
+        const auto &representatives = getImpl()->representatives;
+        if (auto it = representatives.find(type); it != representatives.end()) {
+            return { mlir::DataLayoutEntryAttr::get(it->second, *this) };
+        }
+        return mlir::detail::filterEntriesForType(getEntries(), type);
+    }
+
+    mlir::DataLayoutSpecInterface DataLayoutTableAttr::combineWith(
+        llvm::ArrayRef< mlir::DataLayoutSpecInterface > specs
+    ) const {
+        return getSpec().combineWith(specs);
+    }
+
+    mlir::DataLayoutEntryListRef DataLayoutTableAttr::getEntries() const
+    {
+        return getSpec().getEntries();
+    }
+
+    mlir::StringAttr DataLayoutTableAttr::getEndiannessIdentifier(mcontext_t *mctx) const
+    {
+        return getSpec().getEndiannessIdentifier(mctx);
+    }
+
+    mlir::StringAttr DataLayoutTableAttr::getAllocaMemorySpaceIdentifier(mcontext_t *mctx) const
+    {
+        return getSpec().getAllocaMemorySpaceIdentifier(mctx);
+    }
+
+    mlir::StringAttr DataLayoutTableAttr::getStackAlignmentIdentifier(mcontext_t *mctx) const
+    {
+        return getSpec().getStackAlignmentIdentifier(mctx);
+    }
+
     void CoreDialect::registerAttributes()
     {
         addAttributes<
@@ -4,6 +4,7 @@
 #include "vast/Dialect/Core/CoreOps.hpp"
 #include "vast/Dialect/Core/CoreTypes.hpp"
 #include "vast/Dialect/Core/CoreAttributes.hpp"
+#include "vast/Dialect/Bytecode.hpp"
 
 #include "vast/Interfaces/AliasTypeInterface.hpp"
 
@@ -62,7 +63,7 @@ namespace vast::core
             #include "vast/Dialect/Core/Core.cpp.inc"
         >();
 
-        addInterfaces< CoreOpAsmDialectInterface >();
+        addInterfaces< CoreOpAsmDialectInterface, versioned_bytecode_interface< 1 > >();
     }
 
     using OpBuilder = mlir::OpBuilder;
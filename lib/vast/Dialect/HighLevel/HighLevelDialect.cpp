@@ -4,6 +4,7 @@
 #include "vast/Dialect/HighLevel/HighLevelAttributes.hpp"
 #include "vast/Dialect/HighLevel/HighLevelTypes.hpp"
 #include "vast/Dialect/HighLevel/HighLevelOps.hpp"
+#include "vast/Dialect/Bytecode.hpp"
 
 #include "vast/Interfaces/AliasTypeInterface.hpp"
 
@@ -15,6 +16,7 @@
 #include <mlir/IR/DialectImplementation.h>
 #include <mlir/IR/OpImplementation.h>
 #include <mlir/IR/DialectInterface.h>
+#include <mlir/Interfaces/FoldInterfaces.h>
 
 #include <llvm/ADT/TypeSwitch.h>
 #include <llvm/Support/ErrorHandling.h>
@@ -44,6 +46,15 @@ namespace vast::hl
         }
     };
 
+    struct HighLevelFoldInterface : mlir::DialectFoldInterface
+    {
+        using DialectFoldInterface::DialectFoldInterface;
+
+        // Keep folded constants next to their uses, e.g., in initializers of
+        // variables, instead of hoisting them out of high-level regions.
+        bool shouldMaterializeInto(mlir::Region *) const final { return true; }
+    };
+
     void HighLevelDialect::initialize()
     {
         registerTypes();
@@ -54,7 +65,11 @@ namespace vast::hl
             #include "vast/Dialect/HighLevel/HighLevel.cpp.inc"
         >();
 
-        addInterfaces< HighLevelOpAsmDialectInterface >();
+        addInterfaces<
+            HighLevelOpAsmDialectInterface,
+            HighLevelFoldInterface,
+            versioned_bytecode_interface< 1 >
+        >();
     }
 
     using DialectParser = mlir::AsmParser;
@@ -62,7 +77,12 @@ namespace vast::hl
 
     Operation *HighLevelDialect::materializeConstant(Builder &builder, Attribute value, Type type, Location loc)
     {
-        VAST_UNIMPLEMENTED;
+        if (auto typed = mlir::dyn_cast< mlir::TypedAttr >(value)) {
+            if (typed.getType() == type) {
+                return builder.create< ConstantOp >(loc, type, typed);
+            }
+        }
+        return nullptr;
     }
 
 } // namespace vast::hl
@@ -0,0 +1,628 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#include "vast/Util/Warnings.hpp"
+
+VAST_RELAX_WARNINGS
+#include <llvm/ADT/APFloat.h>
+#include <llvm/ADT/APSInt.h>
+#include <mlir/IR/Matchers.h>
+#include <mlir/IR/PatternMatch.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Dialect/HighLevel/HighLevelAttributes.hpp"
+#include "vast/Dialect/HighLevel/HighLevelDialect.hpp"
+#include "vast/Dialect/HighLevel/HighLevelOps.hpp"
+#include "vast/Dialect/HighLevel/HighLevelTypes.hpp"
+
+#include "vast/Dialect/Core/CoreAttributes.hpp"
+#include "vast/Dialect/Core/CoreDialect.hpp"
+
+#include "vast/Util/Common.hpp"
+#include "vast/Util/DataLayout.hpp"
+
+#include <optional>
+
+//
+// Folding of high-level operations with constant operands.
+//
+// Folds are implemented as canonicalization patterns rather than operation
+// folders: dialect conversion folds illegal operations in place before it
+// applies patterns, which would change the output of every lowering. The
+// patterns run only as a part of canonicalization, e.g., by `-vast-simplify`.
+//
+namespace vast::hl
+{
+    namespace
+    {
+        struct integer_semantics
+        {
+            unsigned width;
+            bool is_signed;
+        };
+
+        // Widths of high-level integers are given by the data layout of the
+        // module, there is nothing to fold with if it is missing.
+        std::optional< integer_semantics > semantics_of_integer(operation op, mlir_type type) {
+            if (auto builtin = mlir::dyn_cast< mlir::IntegerType >(type)) {
+                return integer_semantics{ builtin.getWidth(), !builtin.isUnsigned() };
+            }
+
+            if (!isIntegerType(type)) {
+                return std::nullopt;
+            }
+
+            auto mod = op->getParentOfType< vast_module >();
+            if (!mod) {
+                return std::nullopt;
+            }
+
+            auto table = mod->getAttrOfType< core::DataLayoutTableAttr >(
+                core::CoreDialect::getDataLayoutAttrName()
+            );
+
+            auto entry = table ? table.lookup(type) : nullptr;
+            if (!entry || entry->bw == 0) {
+                return std::nullopt;
+            }
+
+            return integer_semantics{ entry->bw, isSigned(type) };
+        }
+
+        const llvm::fltSemantics *semantics_of_float(mlir_type type) {
+            if (auto builtin = mlir::dyn_cast< mlir::FloatType >(type)) {
+                return &builtin.getFloatSemantics();
+            }
+            if (mlir::isa< FloatType >(type)) {
+                return &llvm::APFloat::IEEEsingle();
+            }
+            if (mlir::isa< DoubleType >(type)) {
+                return &llvm::APFloat::IEEEdouble();
+            }
+            return nullptr;
+        }
+
+        mlir::Attribute constant_of(mlir_value value) {
+            mlir::Attribute attr;
+            if (mlir::matchPattern(value, mlir::m_Constant(&attr))) {
+                return attr;
+            }
+            return {};
+        }
+
+        std::optional< llvm::APSInt > integer_of(mlir::Attribute attr, integer_semantics sem) {
+            std::optional< llvm::APSInt > value;
+            if (auto integer = mlir::dyn_cast_or_null< core::IntegerAttr >(attr)) {
+                value = integer.getValue().extOrTrunc(sem.width);
+            } else if (auto boolean = mlir::dyn_cast_or_null< core::BooleanAttr >(attr)) {
+                value = llvm::APSInt(llvm::APInt(sem.width, boolean.getValue()), true);
+            }
+
+            if (value) {
+                value->setIsSigned(sem.is_signed);
+            }
+            return value;
+        }
+
+        std::optional< llvm::APSInt > integer_of(operation op, mlir_value value) {
+            auto sem = semantics_of_integer(op, value.getType());
+            if (!sem) {
+                return std::nullopt;
+            }
+            return integer_of(constant_of(value), *sem);
+        }
+
+        std::optional< llvm::APFloat > float_of(mlir_value value) {
+            if (auto attr = mlir::dyn_cast_or_null< core::FloatAttr >(constant_of(value))) {
+                return attr.getValue();
+            }
+            return std::nullopt;
+        }
+
+        std::optional< bool > truth_of(mlir_value value) {
+            auto attr = constant_of(value);
+            if (auto boolean = mlir::dyn_cast_or_null< core::BooleanAttr >(attr)) {
+                return boolean.getValue();
+            }
+            if (auto integer = mlir::dyn_cast_or_null< core::IntegerAttr >(attr)) {
+                return !integer.getValue().isZero();
+            }
+            if (auto floating = mlir::dyn_cast_or_null< core::FloatAttr >(attr)) {
+                return !floating.getValue().isZero();
+            }
+            return std::nullopt;
+        }
+
+        // Result of a comparison, i.e., `bool` in C++ and `int` in C.
+        FoldResult make_truth(operation op, mlir_type type, bool value) {
+            if (mlir::isa< BoolType >(type)) {
+                return core::BooleanAttr::get(type, value);
+            }
+
+            if (auto sem = semantics_of_integer(op, type)) {
+                return core::IntegerAttr::get(
+                    type, llvm::APSInt(llvm::APInt(sem->width, value), !sem->is_signed)
+                );
+            }
+
+            return {};
+        }
+
+        //
+        // integer arithmetic
+        //
+        template< typename compute_t >
+        FoldResult fold_integer_binary(operation op, mlir_value lhs, mlir_value rhs, compute_t &&compute) {
+            auto type = op->getResult(0).getType();
+            auto sem  = semantics_of_integer(op, type);
+            if (!sem || lhs.getType() != rhs.getType() || lhs.getType() != type) {
+                return {};
+            }
+
+            auto l = integer_of(constant_of(lhs), *sem);
+            auto r = integer_of(constant_of(rhs), *sem);
+            if (!l || !r) {
+                return {};
+            }
+
+            if (auto result = compute(*l, *r)) {
+                return core::IntegerAttr::get(type, llvm::APSInt(*result, !sem->is_signed));
+            }
+
+            return {};
+        }
+
+        bool is_integer_constant(mlir_value value, std::uint64_t expected) {
+            auto attr = mlir::dyn_cast_or_null< core::IntegerAttr >(constant_of(value));
+            return attr && attr.getValue() == expected;
+        }
+
+        // `x op identity` is `x` if nothing is converted by the operation.
+        FoldResult fold_identity(operation op, mlir_value lhs, mlir_value rhs, std::uint64_t identity) {
+            auto type = op->getResult(0).getType();
+            if (lhs.getType() == type && is_integer_constant(rhs, identity)) {
+                return lhs;
+            }
+            return {};
+        }
+
+        using maybe_ap_int = std::optional< ap_int >;
+
+        FoldResult fold(AddIOp op) {
+            if (auto result = fold_identity(op, op.getLhs(), op.getRhs(), 0)) {
+                return result;
+            }
+            if (auto result = fold_identity(op, op.getRhs(), op.getLhs(), 0)) {
+                return result;
+            }
+            return fold_integer_binary(op, op.getLhs(), op.getRhs(),
+                [] (const ap_int &l, const ap_int &r) -> maybe_ap_int { return l + r; }
+            );
+        }
+
+        FoldResult fold(SubIOp op) {
+            if (auto result = fold_identity(op, op.getLhs(), op.getRhs(), 0)) {
+                return result;
+            }
+            return fold_integer_binary(op, op.getLhs(), op.getRhs(),
+                [] (const ap_int &l, const ap_int &r) -> maybe_ap_int { return l - r; }
+            );
+        }
+
+        FoldResult fold(MulIOp op) {
+            if (auto result = fold_identity(op, op.getLhs(), op.getRhs(), 1)) {
+                return result;
+            }
+            if (auto result = fold_identity(op, op.getRhs(), op.getLhs(), 1)) {
+                return result;
+            }
+            return fold_integer_binary(op, op.getLhs(), op.getRhs(),
+                [] (const ap_int &l, const ap_int &r) -> maybe_ap_int { return l * r; }
+            );
+        }
+
+        // Division by zero and signed overflow are undefined, hence kept.
+        bool is_signed_overflow(const ap_int &l, const ap_int &r) {
+            return l.isMinSignedValue() && r.isAllOnes();
+        }
+
+        FoldResult fold(DivSOp op) {
+            return fold_integer_binary(op, op.getLhs(), op.getRhs(),
+                [] (const ap_int &l, const ap_int &r) -> maybe_ap_int {
+                    if (r.isZero() || is_signed_overflow(l, r)) {
+                        return std::nullopt;
+                    }
+                    return l.sdiv(r);
+                }
+            );
+        }
+
+        FoldResult fold(DivUOp op) {
+            return fold_integer_binary(op, op.getLhs(), op.getRhs(),
+                [] (const ap_int &l, const ap_int &r) -> maybe_ap_int {
+                    if (r.isZero()) {
+                        return std::nullopt;
+                    }
+                    return l.udiv(r);
+                }
+            );
+        }
+
+        FoldResult fold(RemSOp op) {
+            return fold_integer_binary(op, op.getLhs(), op.getRhs(),
+                [] (const ap_int &l, const ap_int &r) -> maybe_ap_int {
+                    if (r.isZero() || is_signed_overflow(l, r)) {
+                        return std::nullopt;
+                    }
+                    return l.srem(r);
+                }
+            );
+        }
+
+        FoldResult fold(RemUOp op) {
+            return fold_integer_binary(op, op.getLhs(), op.getRhs(),
+                [] (const ap_int &l, const ap_int &r) -> maybe_ap_int {
+                    if (r.isZero()) {
+                        return std::nullopt;
+                    }
+                    return l.urem(r);
+                }
+            );
+        }
+
+        FoldResult fold(BinAndOp op) {
+            return fold_integer_binary(op, op.getLhs(), op.getRhs(),
+                [] (const ap_int &l, const ap_int &r) -> maybe_ap_int { return l & r; }
+            );
+        }
+
+        FoldResult fold(BinOrOp op) {
+            return fold_integer_binary(op, op.getLhs(), op.getRhs(),
+                [] (const ap_int &l, const ap_int &r) -> maybe_ap_int { return l | r; }
+            );
+        }
+
+        FoldResult fold(BinXorOp op) {
+            return fold_integer_binary(op, op.getLhs(), op.getRhs(),
+                [] (const ap_int &l, const ap_int &r) -> maybe_ap_int { return l ^ r; }
+            );
+        }
+
+        // Shifts by negative amounts or by at least the width are undefined.
+        template< typename op_t, typename compute_t >
+        FoldResult fold_shift(op_t op, compute_t &&compute) {
+            auto type = op.getType();
+            auto sem  = semantics_of_integer(op, type);
+            if (!sem || op.getLhs().getType() != type) {
+                return {};
+            }
+
+            auto l = integer_of(constant_of(op.getLhs()), *sem);
+            auto r = integer_of(op, op.getRhs());
+            if (!l || !r || r->isNegative() || r->uge(sem->width)) {
+                return {};
+            }
+
+            return core::IntegerAttr::get(
+                type, llvm::APSInt(compute(*l, unsigned(r->getZExtValue())), !sem->is_signed)
+            );
+        }
+
+        FoldResult fold(BinShlOp op) {
+            return fold_shift(op, [] (const ap_int &l, unsigned r) { return l.shl(r); });
+        }
+
+        FoldResult fold(BinLShrOp op) {
+            return fold_shift(op, [] (const ap_int &l, unsigned r) { return l.lshr(r); });
+        }
+
+        FoldResult fold(BinAShrOp op) {
+            return fold_shift(op, [] (const ap_int &l, unsigned r) { return l.ashr(r); });
+        }
+
+        //
+        // floating-point arithmetic
+        //
+        template< typename compute_t >
+        FoldResult fold_float_binary(operation op, mlir_value lhs, mlir_value rhs, compute_t &&compute) {
+            auto type = op->getResult(0).getType();
+            if (lhs.getType() != type || rhs.getType() != type) {
+                return {};
+            }
+
+            auto l = float_of(lhs);
+            auto r = float_of(rhs);
+            if (!l || !r || &l->getSemantics() != &r->getSemantics()) {
+                return {};
+            }
+
+            auto status = compute(*l, *r);
+            if (status & llvm::APFloat::opInvalidOp) {
+                return {};
+            }
+
+            return core::FloatAttr::get(type, *l);
+        }
+
+        constexpr auto rounding = llvm::APFloat::rmNearestTiesToEven;
+
+        FoldResult fold(AddFOp op) {
+            return fold_float_binary(op, op.getLhs(), op.getRhs(),
+                [] (llvm::APFloat &l, const llvm::APFloat &r) { return l.add(r, rounding); }
+            );
+        }
+
+        FoldResult fold(SubFOp op) {
+            return fold_float_binary(op, op.getLhs(), op.getRhs(),
+                [] (llvm::APFloat &l, const llvm::APFloat &r) { return l.subtract(r, rounding); }
+            );
+        }
+
+        FoldResult fold(MulFOp op) {
+            return fold_float_binary(op, op.getLhs(), op.getRhs(),
+                [] (llvm::APFloat &l, const llvm::APFloat &r) { return l.multiply(r, rounding); }
+            );
+        }
+
+        FoldResult fold(DivFOp op) {
+            return fold_float_binary(op, op.getLhs(), op.getRhs(),
+                [] (llvm::APFloat &l, const llvm::APFloat &r) { return l.divide(r, rounding); }
+            );
+        }
+
+        //
+        // unary operations
+        //
+        FoldResult fold(PlusOp op) {
+            if (op.getArg().getType() == op.getType()) {
+                return op.getArg();
+            }
+            return {};
+        }
+
+        FoldResult fold(MinusOp op) {
+            auto type = op.getType();
+            if (auto value = float_of(op.getArg())) {
+                value->changeSign();
+                return core::FloatAttr::get(type, *value);
+            }
+
+            auto sem = semantics_of_integer(op, type);
+            if (!sem) {
+                return {};
+            }
+
+            auto value = integer_of(constant_of(op.getArg()), *sem);
+            if (!value || (sem->is_signed && value->isMinSignedValue())) {
+                return {};
+            }
+
+            return core::IntegerAttr::get(type, -*value);
+        }
+
+        FoldResult fold(NotOp op) {
+            auto type = op.getType();
+            auto sem  = semantics_of_integer(op, type);
+            if (!sem) {
+                return {};
+            }
+
+            if (auto value = integer_of(constant_of(op.getArg()), *sem)) {
+                return core::IntegerAttr::get(type, ~*value);
+            }
+
+            return {};
+        }
+
+        FoldResult fold(LNotOp op) {
+            if (auto value = truth_of(op.getArg())) {
+                return make_truth(op, op.getType(), !*value);
+            }
+            return {};
+        }
+
+        //
+        // comparisons
+        //
+        FoldResult fold(CmpOp op) {
+            auto lhs = op.getLhs();
+            auto rhs = op.getRhs();
+            if (lhs.getType() != rhs.getType()) {
+                return {};
+            }
+
+            auto l = integer_of(op, lhs);
+            auto r = integer_of(op, rhs);
+            if (!l || !r) {
+                return {};
+            }
+
+            auto result = [&] {
+                switch (op.getPredicate()) {
+                    case Predicate::eq:  return l->eq(*r);
+                    case Predicate::ne:  return l->ne(*r);
+                    case Predicate::slt: return l->slt(*r);
+                    case Predicate::sle: return l->sle(*r);
+                    case Predicate::sgt: return l->sgt(*r);
+                    case Predicate::sge: return l->sge(*r);
+                    case Predicate::ult: return l->ult(*r);
+                    case Predicate::ule: return l->ule(*r);
+                    case Predicate::ugt: return l->ugt(*r);
+                    case Predicate::uge: return l->uge(*r);
+                }
+                VAST_UNREACHABLE("unknown predicate");
+            }();
+
+            return make_truth(op, op.getType(), result);
+        }
+
+        FoldResult fold(FCmpOp op) {
+            auto l = float_of(op.getLhs());
+            auto r = float_of(op.getRhs());
+            if (!l || !r || &l->getSemantics() != &r->getSemantics()) {
+                return {};
+            }
+
+            using cmp = llvm::APFloat::cmpResult;
+            auto cr = l->compare(*r);
+
+            bool un = cr == cmp::cmpUnordered;
+            bool lt = cr == cmp::cmpLessThan;
+            bool eq = cr == cmp::cmpEqual;
+            bool gt = cr == cmp::cmpGreaterThan;
+
+            auto result = [&] {
+                switch (op.getPredicate()) {
+                    case FPredicate::ffalse: return false;
+                    case FPredicate::oeq:    return eq;
+                    case FPredicate::ogt:    return gt;
+                    case FPredicate::oge:    return gt || eq;
+                    case FPredicate::olt:    return lt;
+                    case FPredicate::ole:    return lt || eq;
+                    case FPredicate::one:    return lt || gt;
+                    case FPredicate::ord:    return !un;
+                    case FPredicate::uno:    return un;
+                    case FPredicate::ueq:    return un || eq;
+                    case FPredicate::ugt:    return un || gt;
+                    case FPredicate::uge:    return un || gt || eq;
+                    case FPredicate::ult:    return un || lt;
+                    case FPredicate::ule:    return un || lt || eq;
+                    case FPredicate::une:    return !eq;
+                    case FPredicate::ftrue:  return true;
+                }
+                VAST_UNREACHABLE("unknown predicate");
+            }();
+
+            return make_truth(op, op.getType(), result);
+        }
+
+        //
+        // casts
+        //
+        FoldResult fold_cast(operation op, mlir_value arg, CastKind kind) {
+            auto src = arg.getType();
+            auto dst = op->getResult(0).getType();
+
+            switch (kind) {
+                case CastKind::NoOp: {
+                    if (src == dst) {
+                        return arg;
+                    }
+                    return {};
+                }
+                case CastKind::IntegralCast: {
+                    auto sem = semantics_of_integer(op, dst);
+                    auto value = mlir::isa< BoolType >(src)
+                        ? integer_of(constant_of(arg), integer_semantics{ 1, false })
+                        : integer_of(op, arg);
+                    if (!sem || !value) {
+                        return {};
+                    }
+                    auto result = value->extOrTrunc(sem->width);
+                    result.setIsSigned(sem->is_signed);
+                    return core::IntegerAttr::get(dst, result);
+                }
+                case CastKind::IntegralToBoolean:
+                case CastKind::FloatingToBoolean: {
+                    if (!mlir::isa< BoolType >(dst)) {
+                        return {};
+                    }
+                    if (auto value = truth_of(arg)) {
+                        return core::BooleanAttr::get(dst, *value);
+                    }
+                    return {};
+                }
+                case CastKind::IntegralToFloating: {
+                    auto sem   = semantics_of_float(dst);
+                    auto value = integer_of(op, arg);
+                    if (!sem || !value) {
+                        return {};
+                    }
+                    llvm::APFloat result(*sem);
+                    result.convertFromAPInt(*value, value->isSigned(), rounding);
+                    return core::FloatAttr::get(dst, result);
+                }
+                case CastKind::FloatingToIntegral: {
+                    auto sem   = semantics_of_integer(op, dst);
+                    auto value = float_of(arg);
+                    if (!sem || !value) {
+                        return {};
+                    }
+                    // Values out of range of the integer are undefined.
+                    llvm::APSInt result(sem->width, !sem->is_signed);
+                    bool is_exact = false;
+                    auto status = value->convertToInteger(
+                        result, llvm::APFloat::rmTowardZero, &is_exact
+                    );
+                    if (status & llvm::APFloat::opInvalidOp) {
+                        return {};
+                    }
+                    return core::IntegerAttr::get(dst, result);
+                }
+                case CastKind::FloatingCast: {
+                    auto sem   = semantics_of_float(dst);
+                    auto value = float_of(arg);
+                    if (!sem || !value) {
+                        return {};
+                    }
+                    bool loses_info = false;
+                    value->convert(*sem, rounding, &loses_info);
+                    return core::FloatAttr::get(dst, *value);
+                }
+                default:
+                    return {};
+            }
+        }
+
+        FoldResult fold(ImplicitCastOp op) {
+            return fold_cast(op, op.getValue(), op.getKind());
+        }
+
+        FoldResult fold(CStyleCastOp op) {
+            return fold_cast(op, op.getValue(), op.getKind());
+        }
+
+        //
+        // Replaces an operation by its folded value or by a new constant.
+        //
+        template< typename op_t >
+        struct fold_pattern : mlir::OpRewritePattern< op_t >
+        {
+            using base = mlir::OpRewritePattern< op_t >;
+            using base::base;
+
+            logical_result matchAndRewrite(op_t op, mlir::PatternRewriter &rewriter) const override {
+                auto result = fold(op);
+                if (!result) {
+                    return mlir::failure();
+                }
+
+                if (auto value = result.dyn_cast< mlir_value >()) {
+                    rewriter.replaceOp(op, value);
+                    return mlir::success();
+                }
+
+                auto attr = mlir::cast< mlir::TypedAttr >(result.get< mlir::Attribute >());
+                rewriter.replaceOpWithNewOp< ConstantOp >(op, attr.getType(), attr);
+                return mlir::success();
+            }
+        };
+
+        template< typename... ops_t >
+        void add_fold_patterns(mlir::RewritePatternSet &patterns) {
+            (patterns.add< fold_pattern< ops_t > >(patterns.getContext()), ...);
+        }
+
+    } // namespace
+
+    void HighLevelDialect::getCanonicalizationPatterns(mlir::RewritePatternSet &patterns) const {
+        add_fold_patterns<
+            AddIOp, SubIOp, MulIOp, DivSOp, DivUOp, RemSOp, RemUOp,
+            BinAndOp, BinOrOp, BinXorOp, BinShlOp, BinLShrOp, BinAShrOp,
+            AddFOp, SubFOp, MulFOp, DivFOp,
+            PlusOp, MinusOp, NotOp, LNotOp,
+            CmpOp, FCmpOp,
+            ImplicitCastOp, CStyleCastOp
+        >(patterns);
+    }
+
+} // namespace vast::hl
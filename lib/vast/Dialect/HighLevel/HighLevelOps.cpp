@@ -6,6 +6,7 @@ VAST_RELAX_WARNINGS
 #include <mlir/Interfaces/CallInterfaces.h>
 #include <mlir/Support/LLVM.h>
 #include <mlir/Support/LogicalResult.h>
+#include <mlir/IR/AttrTypeSubElements.h>
 #include <mlir/IR/Builders.h>
 #include <mlir/IR/OperationSupport.h>
 #include <mlir/IR/SymbolTable.h>
@@ -69,6 +70,64 @@ namespace vast::hl
         return adaptor.getValue();
     }
 
+    //===----------------------------------------------------------------------===//
+    // CastOps
+    //===----------------------------------------------------------------------===//
+
+    using memory_effects = llvm::SmallVectorImpl<
+        mlir::SideEffects::EffectInstance< mlir::MemoryEffects::Effect >
+    >;
+
+    // Conservatively, typedefs might hide the qualifier.
+    static bool may_be_volatile(mlir_type type) {
+        bool result = false;
+        mlir::AttrTypeWalker walker;
+        walker.addWalk([&] (VolatileQualifierInterface quals) {
+            result |= quals.hasVolatile();
+        });
+        walker.addWalk([&] (TypedefType) { result = true; });
+        walker.walk(type);
+        return result;
+    }
+
+    static void get_cast_effects(CastKind kind, mlir_value value, memory_effects &effects) {
+        switch (kind) {
+            case CastKind::LValueToRValue:
+            case CastKind::LValueToRValueBitCast:
+                effects.emplace_back(mlir::MemoryEffects::Read::get());
+                // Volatile reads must stay where they are.
+                if (may_be_volatile(value.getType())) {
+                    effects.emplace_back(mlir::MemoryEffects::Write::get());
+                }
+                return;
+            case CastKind::Dynamic:
+            case CastKind::UserDefinedConversion:
+            case CastKind::ConstructorConversion:
+            case CastKind::ARCProduceObject:
+            case CastKind::ARCConsumeObject:
+            case CastKind::ARCReclaimReturnedObject:
+            case CastKind::ARCExtendBlockObject:
+            case CastKind::CopyAndAutoreleaseBlockObject:
+                effects.emplace_back(mlir::MemoryEffects::Read::get());
+                effects.emplace_back(mlir::MemoryEffects::Write::get());
+                return;
+            default:
+                return;
+        }
+    }
+
+    void ImplicitCastOp::getEffects(memory_effects &effects) {
+        get_cast_effects(getKind(), getValue(), effects);
+    }
+
+    void CStyleCastOp::getEffects(memory_effects &effects) {
+        get_cast_effects(getKind(), getValue(), effects);
+    }
+
+    void BuiltinBitCastOp::getEffects(memory_effects &effects) {
+        get_cast_effects(getKind(), getValue(), effects);
+    }
+
 
     void build_expr_trait(Builder &bld, State &st, Type rty, BuilderCallback expr) {
         VAST_ASSERT(expr && "the builder callback for 'expr' region must be present");
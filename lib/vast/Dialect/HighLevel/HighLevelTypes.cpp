@@ -3,6 +3,7 @@
 #include "vast/Dialect/HighLevel/HighLevelAttributes.hpp"
 #include "vast/Dialect/HighLevel/HighLevelTypes.hpp"
 #include "vast/Dialect/HighLevel/HighLevelOps.hpp"
+#include "vast/Dialect/HighLevel/TypedefResolver.hpp"
 #include "vast/Util/TypeList.hpp"
 #include <sstream>
 
@@ -38,16 +39,14 @@ namespace vast::hl
         return t;
     }
 
-    mlir_type getBottomTypedefType(TypedefType def, vast_module mod)
+    mlir_type getBottomTypedefType(TypedefType def, operation user, const typedef_resolver &typedefs)
     {
-        return getBottomTypedefType(getTypedefType(def, mod), mod);
+        return typedefs.bottom(def, user);
     }
 
-    mlir_type getBottomTypedefType(mlir_type type, vast_module mod)
+    mlir_type getBottomTypedefType(mlir_type type, operation user, const typedef_resolver &typedefs)
     {
-        if (auto def = mlir::dyn_cast_or_null< TypedefType >(strip_elaborated(type)))
-            return getBottomTypedefType(def, mod);
-        return type;
+        return typedefs.bottom(type, user);
     }
 
     mlir_type getTypedefType(TypedefType type, vast_module mod)
@@ -75,29 +74,32 @@ namespace vast::hl
         return {};
     }
 
-    core::FunctionType getFunctionType(mlir_type type, vast_module mod) {
+    core::FunctionType getFunctionType(
+        mlir_type type, operation user, const typedef_resolver &typedefs
+    ) {
         if (auto ty = type.dyn_cast< core::FunctionType >())
             return ty;
         if (auto ty = dyn_cast< ElementTypeInterface >(type))
-            return getFunctionType(ty.getElementType(), mod);
+            return getFunctionType(ty.getElementType(), user, typedefs);
         if (auto ty = type.dyn_cast< TypedefType >())
-            return getFunctionType(getTypedefType(ty, mod), mod);
+            return getFunctionType(typedefs.aliased(ty, user), user, typedefs);
 
         return {};
     }
 
-    core::FunctionType getFunctionType(mlir_value callee) {
-        auto op  = callee.getDefiningOp();
-        auto mod = op->getParentOfType< vast_module >();
-        return getFunctionType(callee.getType(), mod);
+    core::FunctionType getFunctionType(mlir_value callee, const typedef_resolver &typedefs) {
+        auto user = callee.getParentRegion()->getParentOp();
+        return getFunctionType(callee.getType(), user, typedefs);
     }
 
-    core::FunctionType getFunctionType(mlir::CallOpInterface call) {
+    core::FunctionType getFunctionType(mlir::CallOpInterface call, const typedef_resolver &typedefs) {
         auto mod = call->getParentOfType< vast_module >();
-        return getFunctionType(call.getCallableForCallee(), mod);
+        return getFunctionType(call.getCallableForCallee(), mod, typedefs);
     }
 
-    core::FunctionType getFunctionType(mlir::CallInterfaceCallable callee, vast_module mod) {
+    core::FunctionType getFunctionType(
+        mlir::CallInterfaceCallable callee, vast_module mod, const typedef_resolver &typedefs
+    ) {
         if (!callee) {
             return {};
         }
@@ -109,13 +111,12 @@ namespace vast::hl
         }
 
         if (auto value = callee.dyn_cast< mlir_value >()) {
-            return getFunctionType(value.getType(), mod);
+            return getFunctionType(value, typedefs);
         }
 
         return {};
     }
 
-
     void HighLevelDialect::registerTypes() {
         addTypes<
             #define GET_TYPEDEF_LIST
@@ -5,9 +5,12 @@
 VAST_RELAX_WARNINGS
 #include <mlir/Pass/Pass.h>
 #include <mlir/Pass/PassManager.h>
+#include <mlir/Transforms/GreedyPatternRewriteDriver.h>
+#include <mlir/Transforms/Passes.h>
 VAST_UNRELAX_WARNINGS
 
 #include "vast/Dialect/HighLevel/Passes.hpp"
+#include "vast/Dialect/HighLevel/HighLevelOps.hpp"
 
 namespace vast::hl::pipeline {
 
@@ -43,14 +46,40 @@ namespace vast::hl::pipeline {
     //
     // simplifcaiton passes
     //
+    // Dead code lives only in function bodies, so each function is trimmed
+    // in parallel.
     static pipeline_step_ptr dce() {
-        return pass(hl::createDCEPass).depends_on(canonicalize);
+        return nested< hl::FuncOp >(hl::createDCEPass).depends_on(canonicalize);
     }
 
     pipeline_step_ptr simplify() {
         return compose("simplify", dce, desugar);
     }
 
+    //
+    // folding passes
+    //
+    // Regions are left as they are, high-level control flow relies on its
+    // region structure.
+    static std::unique_ptr< mlir::Pass > create_fold_pass() {
+        mlir::GreedyRewriteConfig config;
+        config.enableRegionSimplification = false;
+        return mlir::createCanonicalizerPass(config);
+    }
+
+    static pipeline_step_ptr fold_constants() {
+        return pass(create_fold_pass);
+    }
+
+    static pipeline_step_ptr eliminate_common_subexpressions() {
+        return pass(mlir::createCSEPass);
+    }
+
+    pipeline_step_ptr fold() {
+        return compose("fold", fold_constants, eliminate_common_subexpressions)
+            .depends_on(desugar);
+    }
+
     //
     // stdtypes passes
     //
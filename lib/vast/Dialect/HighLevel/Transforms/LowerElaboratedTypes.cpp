@@ -25,6 +25,8 @@ VAST_UNRELAX_WARNINGS
 
 #include "vast/Dialect/HighLevel/HighLevelDialect.hpp"
 #include "vast/Dialect/HighLevel/HighLevelOps.hpp"
+#include "vast/Dialect/HighLevel/RecordIndex.hpp"
+#include "vast/Dialect/HighLevel/TypedefResolver.hpp"
 
 #include "PassesDetails.hpp"
 
@@ -55,13 +57,17 @@ namespace vast::hl {
                     return {};
                 }
 
-                maybe_type_t convert(mlir_type type) {
+                static mlir_type strip_nested_elaborated(mlir_type type) {
                     mlir::AttrTypeReplacer replacer;
                     replacer.addReplacement([] (mlir_type t) {
                         return hl::strip_elaborated(t);
                     });
                     return replacer.replace(type);
                 }
+
+                maybe_type_t convert(mlir_type type) {
+                    return strip_nested_elaborated(type);
+                }
             };
 
             using lower_elaborated = conv::tc::hl_type_converting_pattern< type_converter >;
@@ -90,12 +96,23 @@ namespace vast::hl {
 
             rewrite_pattern_set patterns(&mctx);
 
+            // Built before the conversion, so that typedef lowering that follows
+            // can reuse it instead of walking the module again.
+            auto &typedefs = getAnalysis< typedef_resolver >();
+
             auto tc = pattern::type_converter(mctx, op);
             patterns.template add< pattern::lower_elaborated >(tc, mctx);
 
             if (mlir::failed(mlir::applyPartialConversion(op, target, std::move(patterns)))) {
                 return signalPassFailure();
             }
+
+            // Keep cached types in sync with the rewritten typedef definitions.
+            typedefs.map_types([] (mlir_type type) {
+                return type ? pattern::type_converter::strip_nested_elaborated(type) : type;
+            });
+
+            markAnalysesPreserved< typedef_resolver, record_index >();
         }
     };
 
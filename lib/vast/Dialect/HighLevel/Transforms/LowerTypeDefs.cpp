@@ -25,6 +25,8 @@ VAST_UNRELAX_WARNINGS
 
 #include "vast/Dialect/HighLevel/HighLevelDialect.hpp"
 #include "vast/Dialect/HighLevel/HighLevelOps.hpp"
+#include "vast/Dialect/HighLevel/RecordIndex.hpp"
+#include "vast/Dialect/HighLevel/TypedefResolver.hpp"
 
 #include "PassesDetails.hpp"
 
@@ -37,27 +39,31 @@ namespace vast::hl {
                 : conv::tc::base_type_converter
                 , conv::tc::mixins< type_converter >
             {
-                vast_module mod;
+                const typedef_resolver &typedefs;
                 mcontext_t &mctx;
 
-                type_converter(mcontext_t &mctx, vast_module mod)
+                // Operation being converted, its typedefs are resolved from
+                // its scope.
+                operation scope = nullptr;
+
+                type_converter(mcontext_t &mctx, const typedef_resolver &typedefs)
                     : conv::tc::base_type_converter(),
-                      mod(mod), mctx(mctx)
+                      typedefs(typedefs), mctx(mctx)
                 {
                     addConversion([&](mlir_type t) { return this->convert(t); });
                 }
 
+                // Converted directly, the conversion cache of the type
+                // converter is not aware of scopes.
                 maybe_types_t do_conversion(mlir_type type) {
-                    types_t out;
-                    if (mlir::succeeded(this->convertTypes(type, out))) {
-                        return { std::move(out) };
+                    if (auto out = convert(type); out && *out) {
+                        return types_t{ *out };
                     }
                     return {};
                 }
 
-                // TODO(conv): This may need to be precomputed instead.
                 maybe_type_t nested_type(mlir_type type) {
-                    return hl::getBottomTypedefType(type, mod);
+                    return typedefs.bottom(type, scope);
                 }
 
                 maybe_type_t convert(mlir_type type) {
@@ -77,6 +83,7 @@ namespace vast::hl {
                     operation op, mlir::ArrayRef< mlir::Value > ops,
                     conversion_rewriter &rewriter
                 ) const override {
+                    get_type_converter().scope = op;
                     auto status = base::matchAndRewrite(op, ops, rewriter);
 
                     if (mlir::isa< hl::TypeDefOp >(op))
@@ -113,12 +120,17 @@ namespace vast::hl {
 
             rewrite_pattern_set patterns(&mctx);
 
-            auto tc = pattern::type_converter(mctx, op);
+            const auto &typedefs = getAnalysis< typedef_resolver >();
+
+            auto tc = pattern::type_converter(mctx, typedefs);
             patterns.template add< pattern::resolve_typedef >(tc, mctx);
 
             if (mlir::failed(mlir::applyPartialConversion(op, target, std::move(patterns)))) {
                 return signalPassFailure();
             }
+
+            // Types are rewritten in place, record definitions are untouched.
+            markAnalysesPreserved< record_index >();
         }
     };
 
@@ -2,6 +2,7 @@
 
 #include "vast/Dialect/LowLevel/LowLevelDialect.hpp"
 #include "vast/Dialect/LowLevel/LowLevelOps.hpp"
+#include "vast/Dialect/Bytecode.hpp"
 
 namespace vast::ll
 {
@@ -11,6 +12,8 @@ namespace vast::ll
             #define GET_OP_LIST
             #include "vast/Dialect/LowLevel/LowLevel.cpp.inc"
         >();
+
+        addInterfaces< versioned_bytecode_interface< 1 > >();
     }
 } // namespace vast::ll
 
@@ -2,6 +2,7 @@
 
 #include "vast/Dialect/Meta/MetaDialect.hpp"
 #include "vast/Dialect/Meta/MetaAttributes.hpp"
+#include "vast/Dialect/Bytecode.hpp"
 
 #include "vast/Util/Symbols.hpp"
 
@@ -15,6 +16,8 @@ namespace vast::meta
             #define GET_OP_LIST
             #include "vast/Dialect/Meta/Meta.cpp.inc"
         >();
+
+        addInterfaces< versioned_bytecode_interface< 1 > >();
     }
 
     static constexpr std::string_view identifier_name = "meta_identifier";
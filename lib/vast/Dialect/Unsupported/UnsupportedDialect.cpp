@@ -6,6 +6,7 @@
 #include "vast/Dialect/Unsupported/UnsupportedDialect.hpp"
 #include "vast/Dialect/Unsupported/UnsupportedOps.hpp"
 #include "vast/Dialect/Unsupported/UnsupportedAttributes.hpp"
+#include "vast/Dialect/Bytecode.hpp"
 
 namespace vast::unsup {
     void UnsupportedDialect::initialize() {
@@ -16,6 +17,8 @@ namespace vast::unsup {
             #define GET_OP_LIST
             #include "vast/Dialect/Unsupported/Unsupported.cpp.inc"
         >();
+
+        addInterfaces< versioned_bytecode_interface< 1 > >();
     }
 } // namespace vast::unsup
 
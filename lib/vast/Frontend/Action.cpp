@@ -36,6 +36,8 @@ namespace vast::cc {
                 return "s";
             case output_type::emit_mlir:
                 return "mlir";
+            case output_type::emit_mlir_bytecode:
+                return "mlirbc";
             case output_type::emit_llvm:
                 return "ll";
             case output_type::emit_obj:
@@ -54,7 +56,8 @@ namespace vast::cc {
             return nullptr;
         }
 
-        return ci.createDefaultOutputFile(false, in, get_output_stream_suffix(act));
+        bool binary = act == output_type::emit_mlir_bytecode;
+        return ci.createDefaultOutputFile(binary, in, get_output_stream_suffix(act));
     }
 
     vast_stream_action::vast_stream_action(output_type act, const vast_args &vargs)
@@ -150,6 +153,13 @@ namespace vast::cc {
         : vast_stream_action(output_type::emit_mlir, vargs)
     {}
 
+    // emit_mlir_bytecode
+    void emit_mlir_bytecode_action::anchor() {}
+
+    emit_mlir_bytecode_action::emit_mlir_bytecode_action(const vast_args &vargs)
+        : vast_stream_action(output_type::emit_mlir_bytecode, vargs)
+    {}
+
     // emit_obj
     void emit_obj_action::anchor() {}
 
@@ -0,0 +1,513 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#include "vast/Frontend/CompilationCache.hpp"
+
+VAST_RELAX_WARNINGS
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/DenseSet.h>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/ADT/StringMap.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/SHA256.h>
+#include <mlir/Bytecode/BytecodeWriter.h>
+#include <mlir/Dialect/LLVMIR/LLVMDialect.h>
+#include <mlir/IR/AttrTypeSubElements.h>
+#include <mlir/IR/Verifier.h>
+#include <mlir/Interfaces/FunctionInterfaces.h>
+#include <mlir/Parser/Parser.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Config/config.h"
+
+#include "vast/Dialect/Core/CoreAttributes.hpp"
+#include "vast/Dialect/Core/CoreDialect.hpp"
+#include "vast/Dialect/HighLevel/HighLevelOps.hpp"
+#include "vast/Dialect/HighLevel/HighLevelTypes.hpp"
+#include "vast/Util/Symbols.hpp"
+
+namespace vast::cc {
+
+    namespace {
+
+        // Bumped whenever the layout of entries changes.
+        constexpr string_ref format_version = "1";
+
+        // Lowering might change between builds of the same version, hence
+        // the build of the compiler is identified by its executable.
+        const std::string &compiler_identity() {
+            static const std::string identity = [] {
+                std::string result(vast::version);
+
+                auto exe = llvm::sys::fs::getMainExecutable(
+                    nullptr, reinterpret_cast< void * >(&compiler_identity)
+                );
+
+                llvm::sys::fs::file_status status;
+                if (!exe.empty() && !llvm::sys::fs::status(exe, status)) {
+                    auto modified = status.getLastModificationTime().time_since_epoch();
+                    result += ";" + std::to_string(status.getSize());
+                    result += ";" + std::to_string(modified.count());
+                }
+
+                return result;
+            }();
+
+            return identity;
+        }
+
+        std::string print(operation op, bool locations) {
+            std::string buff;
+            llvm::raw_string_ostream os(buff);
+
+            // Local scope, so that the printer does not number the whole
+            // module for each printed operation.
+            mlir::OpPrintingFlags flags;
+            flags.enableDebugInfo(locations, /* prettyForm */ false);
+            flags.useLocalScope();
+
+            op->print(os, flags);
+            return os.str();
+        }
+
+        std::string print(mlir::Attribute attr) {
+            std::string buff;
+            llvm::raw_string_ostream os(buff);
+            attr.print(os);
+            return os.str();
+        }
+
+        std::string digest(string_ref text) {
+            return llvm::toHex(llvm::SHA256::hash(llvm::arrayRefFromStringRef(text)), /* lower case */ true);
+        }
+
+        std::optional< string_ref > symbol_name(operation op) {
+            if (auto symbol = mlir::dyn_cast< util::mlir_symbol_interface >(op)) {
+                return symbol.getName();
+            }
+            if (auto symbol = mlir::dyn_cast< util::vast_symbol_interface >(op)) {
+                return symbol.getSymbolName();
+            }
+            return std::nullopt;
+        }
+
+        std::optional< string_ref > type_name(mlir_type type) {
+            if (auto record = mlir::dyn_cast< hl::RecordType >(type)) {
+                return record.getName();
+            }
+            if (auto enum_type = mlir::dyn_cast< hl::EnumType >(type)) {
+                return enum_type.getName();
+            }
+            if (auto typedef_type = mlir::dyn_cast< hl::TypedefType >(type)) {
+                return typedef_type.getName();
+            }
+            return std::nullopt;
+        }
+
+        bool is_function(operation op) {
+            return mlir::isa< mlir::FunctionOpInterface >(op);
+        }
+
+        bool is_definition(operation op) {
+            auto fn = mlir::dyn_cast_or_null< mlir::FunctionOpInterface >(op);
+            return fn && !fn.isExternal();
+        }
+
+        // String literals are local constant globals named by the order of
+        // their lowering, hence their names are the only ones that may be
+        // taken by different operations in another module.
+        bool is_string_literal(operation op) {
+            auto global = mlir::dyn_cast< mlir::LLVM::GlobalOp >(op);
+            if (!global || !global.getConstant()) {
+                return false;
+            }
+
+            auto linkage = global.getLinkage();
+            return (linkage == mlir::LLVM::Linkage::Internal || linkage == mlir::LLVM::Linkage::Private)
+                && mlir::isa_and_present< mlir::StringAttr >(global.getValueOrNull());
+        }
+
+        // Operations the cached lowering refers to have to be either string
+        // literals or lowerings of operations `mod` already has, as these are
+        // covered by the key. Anything else might clash with a different
+        // operation created by the lowering.
+        bool is_spliceable(vast_module entry, vast_module mod) {
+            for (auto &dep : llvm::drop_begin(entry.getBody()->getOperations())) {
+                if (is_function(&dep) || is_string_literal(&dep)) {
+                    continue;
+                }
+
+                auto name = mlir::SymbolTable::getSymbolName(&dep);
+                if (!mlir::SymbolTable::lookupSymbolIn(mod, name)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Yields names by which `root` might refer to module-level operations,
+        // i.e., symbol references, names of named types and, conservatively,
+        // any other string, and types it uses. Regions are visited only if
+        // `nested` is set.
+        void references(operation root, bool nested, auto &&on_name, auto &&on_type) {
+            mlir::AttrTypeWalker walker;
+            walker.addWalk([&] (mlir::SymbolRefAttr ref) {
+                on_name(ref.getRootReference().getValue());
+            });
+            walker.addWalk([&] (mlir::StringAttr str) { on_name(str.getValue()); });
+            walker.addWalk([&] (mlir_type type) {
+                on_type(type);
+                if (auto name = type_name(type)) {
+                    on_name(*name);
+                }
+            });
+
+            auto visit = [&] (operation op) {
+                walker.walk(op->getAttrDictionary());
+                for (auto type : op->getResultTypes()) {
+                    walker.walk(type);
+                }
+                for (auto &region : op->getRegions()) {
+                    for (auto &block : region) {
+                        for (auto arg : block.getArguments()) {
+                            walker.walk(arg.getType());
+                        }
+                    }
+                }
+            };
+
+            if (nested) {
+                root->walk(visit);
+            } else {
+                visit(root);
+            }
+        }
+
+        //
+        // Computes keys of functions of a high-level module. Digests of
+        // module-level operations are shared by the keys of all functions
+        // that depend on them.
+        //
+        struct module_context
+        {
+            module_context(vast_module mod, string_ref configuration) {
+                for (auto &op : mod.getBody()->getOperations()) {
+                    if (auto name = symbol_name(&op)) {
+                        by_name[*name].push_back(&op);
+                    }
+                }
+
+                // Entries of the data layout are hashed only for the types
+                // a function depends on, so that unrelated types do not
+                // invalidate it.
+                auto dl_name = core::CoreDialect::getDataLayoutAttrName();
+                for (auto attr : mod->getAttrs()) {
+                    if (attr.getName().getValue() != dl_name) {
+                        common += print(attr.getName()) + "=" + print(attr.getValue()) + ";";
+                    }
+                }
+
+                if (auto dl = mod->getAttrOfType< core::DataLayoutTableAttr >(dl_name)) {
+                    for (auto entry : dl.getSpec().getEntries()) {
+                        if (auto type = entry.getKey().dyn_cast< mlir_type >()) {
+                            layout.emplace_back(type, print(entry));
+                        }
+                    }
+                }
+
+                common = digest(
+                    llvm::join_items(";", format_version, compiler_identity(), configuration, common)
+                );
+            }
+
+            std::string key(hl::FuncOp fn) {
+                llvm::SHA256 hash;
+                auto add = [&] (string_ref text) {
+                    hash.update(text);
+                    hash.update(string_ref("\0", 1));
+                };
+
+                add(common);
+                // Locations end up in the debug info of the lowered function.
+                add(print(fn, /* locations */ true));
+
+                llvm::DenseSet< operation > seen = { fn.getOperation() };
+                llvm::DenseSet< mlir_type > types;
+                std::vector< operation > worklist;
+
+                auto on_name = [&] (string_ref name) {
+                    auto it = by_name.find(name);
+                    if (it == by_name.end()) {
+                        return;
+                    }
+                    for (auto dep : it->second) {
+                        if (seen.insert(dep).second) {
+                            worklist.push_back(dep);
+                        }
+                    }
+                };
+
+                auto on_type = [&] (mlir_type type) { types.insert(type); };
+
+                references(fn, /* nested */ true, on_name, on_type);
+
+                // Lowering of a function depends only on signatures of
+                // functions it refers to.
+                while (!worklist.empty()) {
+                    auto dep = worklist.back();
+                    worklist.pop_back();
+
+                    add(dependency(dep));
+                    references(dep, /* nested */ !is_function(dep), on_name, on_type);
+                }
+
+                for (const auto &[type, entry] : layout) {
+                    if (types.contains(type)) {
+                        add(entry);
+                    }
+                }
+
+                return llvm::toHex(hash.final(), /* lower case */ true);
+            }
+
+          private:
+            const std::string &dependency(operation op) {
+                auto [it, inserted] = digests.try_emplace(op);
+                if (inserted) {
+                    it->second = digest(is_function(op)
+                        ? op->getName().getStringRef().str() + print(op->getAttrDictionary())
+                        : print(op, /* locations */ false)
+                    );
+                }
+                return it->second;
+            }
+
+            std::string common;
+            llvm::StringMap< llvm::SmallVector< operation, 1 > > by_name;
+            llvm::DenseMap< operation, std::string > digests;
+            std::vector< std::pair< mlir_type, std::string > > layout;
+        };
+
+        // Keeps only the declaration of `fn`, so that its users are lowered
+        // as usual while its body is not lowered at all.
+        void drop_body(hl::FuncOp fn) {
+            fn.eraseBody();
+            fn.setLinkage(core::GlobalLinkageKind::ExternalLinkage);
+            // MLIR requires declarations to have private visibility.
+            fn.setVisibility(mlir::SymbolTable::Visibility::Private);
+        }
+
+        bool equivalent(operation lhs, operation rhs) {
+            return lhs->getName() == rhs->getName()
+                && print(lhs, /* locations */ false) == print(rhs, /* locations */ false);
+        }
+
+        std::string unique_name(string_ref name, mlir::SymbolTable &symbols, vast_module entry) {
+            for (unsigned suffix = 1;; ++suffix) {
+                auto candidate = (name + "_" + llvm::Twine(suffix)).str();
+                if (!symbols.lookup(candidate) && !mlir::SymbolTable::lookupSymbolIn(entry, candidate)) {
+                    return candidate;
+                }
+            }
+        }
+
+        // Moves the cached function of `entry` to the module of `symbols` in
+        // place of its lowered declaration, together with the operations it
+        // refers to that the module does not have yet. String literals whose
+        // names are taken by different operations are renamed, any other
+        // clash is an error.
+        logical_result splice(vast_module entry, mlir::SymbolTable &symbols) {
+            auto ops = llvm::to_vector(llvm::make_pointer_range(entry.getBody()->getOperations()));
+            auto fn  = ops.front();
+
+            // Dependencies are stored after their users, renamed operations
+            // are then compared with their users already updated.
+            llvm::SmallVector< operation > moved;
+            for (auto dep : llvm::reverse(llvm::drop_begin(ops))) {
+                auto name = mlir::SymbolTable::getSymbolName(dep);
+                auto present = symbols.lookup(name);
+                if (!present) {
+                    moved.push_back(dep);
+                    continue;
+                }
+
+                if (is_function(dep) || equivalent(dep, present)) {
+                    continue;
+                }
+
+                if (!is_string_literal(dep)) {
+                    return mlir::failure();
+                }
+
+                auto fresh = mlir::StringAttr::get(entry.getContext(), unique_name(name.getValue(), symbols, entry));
+                if (mlir::failed(mlir::SymbolTable::replaceAllSymbolUses(dep, fresh, entry))) {
+                    return mlir::failure();
+                }
+                mlir::SymbolTable::setSymbolName(dep, fresh);
+                moved.push_back(dep);
+            }
+
+            auto &body = symbols.getOp()->getRegion(0).front();
+            for (auto dep : moved) {
+                dep->remove();
+                symbols.insert(dep, body.begin());
+            }
+
+            auto where = body.end();
+            if (auto declaration = symbols.lookup(mlir::SymbolTable::getSymbolName(fn))) {
+                where = std::next(mlir::Block::iterator(declaration));
+                symbols.erase(declaration);
+            }
+
+            fn->remove();
+            symbols.insert(fn, where);
+            return mlir::success();
+        }
+
+    } // namespace
+
+    compilation_cache::compilation_cache(std::string directory, std::string configuration)
+        : directory(std::move(directory)), configuration(std::move(configuration))
+    {
+        if (auto ec = llvm::sys::fs::create_directories(this->directory)) {
+            VAST_FATAL("cannot create compilation cache {0}: {1}", this->directory, ec.message());
+        }
+    }
+
+    void compilation_cache::prepare(vast_module mod) {
+        module_context context(mod, configuration);
+
+        // Keys are computed before any body is dropped, as dropping changes
+        // signatures that other keys depend on.
+        llvm::SmallVector< hl::FuncOp > functions;
+        for (auto fn : mod.getOps< hl::FuncOp >()) {
+            if (fn.isDeclaration()) {
+                continue;
+            }
+
+            auto key = context.key(fn);
+            auto cached = load(key, *mod.getContext());
+            if (cached && !is_spliceable(cached.get(), mod)) {
+                cached = {};
+            }
+
+            if (cached) {
+                functions.push_back(fn);
+            }
+
+            entries.push_back({ fn.getSymName().str(), std::move(key), std::move(cached) });
+        }
+
+        for (auto fn : functions) {
+            drop_body(fn);
+        }
+
+        hits   += std::int64_t(functions.size());
+        misses += std::int64_t(entries.size() - functions.size());
+    }
+
+    logical_result compilation_cache::finish(vast_module mod) {
+        mlir::SymbolTable symbols(mod);
+
+        for (const auto &entry : entries) {
+            if (entry.cached) {
+                continue;
+            }
+
+            if (auto lowered = symbols.lookup(entry.name); is_definition(lowered)) {
+                store(entry.key, lowered, symbols);
+            }
+        }
+
+        for (auto &entry : entries) {
+            if (entry.cached && mlir::failed(splice(entry.cached.get(), symbols))) {
+                return mlir::failure();
+            }
+        }
+
+        entries.clear();
+        return mlir::verify(mod);
+    }
+
+    std::string compilation_cache::path_of(string_ref key) const {
+        llvm::SmallString< 128 > path(directory);
+        llvm::sys::path::append(path, key + ".mlirbc");
+        return path.str().str();
+    }
+
+    mlir::OwningOpRef< mlir::ModuleOp > compilation_cache::load(string_ref key, mcontext_t &mctx) const {
+        auto path = path_of(key);
+        if (!llvm::sys::fs::exists(path)) {
+            return {};
+        }
+
+        // The whole module is verified once cached functions are spliced.
+        mlir::ParserConfig config(&mctx, /* verify after parse */ false);
+        auto entry = mlir::parseSourceFile< mlir::ModuleOp >(path, config);
+        if (!entry || entry->getBody()->empty() || !is_definition(&entry->getBody()->front())) {
+            return {};
+        }
+
+        return entry;
+    }
+
+    void compilation_cache::store(string_ref key, operation lowered, mlir::SymbolTable &symbols) const {
+        auto entry = mlir::OwningOpRef< mlir::ModuleOp >(mlir::ModuleOp::create(lowered->getLoc()));
+        auto body  = entry->getBody();
+        body->push_back(lowered->clone());
+
+        // Module-level operations the function refers to, referred functions
+        // are stored as declarations.
+        llvm::DenseSet< operation > seen = { lowered };
+        std::vector< operation > worklist = { lowered };
+        while (!worklist.empty()) {
+            auto op = worklist.back();
+            worklist.pop_back();
+
+            auto uses = mlir::SymbolTable::getSymbolUses(op);
+            if (!uses) {
+                continue;
+            }
+
+            for (const auto &use : *uses) {
+                auto dep = symbols.lookup(use.getSymbolRef().getRootReference());
+                if (!dep || !seen.insert(dep).second) {
+                    continue;
+                }
+
+                if (is_function(dep)) {
+                    body->push_back(dep->cloneWithoutRegions());
+                } else {
+                    body->push_back(dep->clone());
+                    worklist.push_back(dep);
+                }
+            }
+        }
+
+        // Entries are written to a temporary file first, concurrent
+        // compilations might store the same entry.
+        auto path = path_of(key);
+        int fd = 0;
+        llvm::SmallString< 128 > temporary;
+        if (llvm::sys::fs::createUniqueFile(path + ".%%%%%%", fd, temporary)) {
+            VAST_REPORT("cannot create compilation cache entry {0}", path);
+            return;
+        }
+
+        {
+            llvm::raw_fd_ostream os(fd, /* should close */ true);
+            if (mlir::failed(mlir::writeBytecodeToFile(entry.get(), os)) || os.has_error()) {
+                os.clear_error();
+                llvm::sys::fs::remove(temporary);
+                VAST_REPORT("cannot write compilation cache entry {0}", path);
+                return;
+            }
+        }
+
+        if (llvm::sys::fs::rename(temporary, path)) {
+            llvm::sys::fs::remove(temporary);
+        }
+    }
+
+} // namespace vast::cc
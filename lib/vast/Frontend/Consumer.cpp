@@ -3,8 +3,17 @@
 #include "vast/Frontend/Consumer.hpp"
 
 VAST_RELAX_WARNINGS
+#include <clang/Basic/DiagnosticFrontend.h>
+#include <clang/Frontend/TextDiagnosticBuffer.h>
+
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/FormatVariadic.h>
+#include <llvm/Support/Path.h>
 #include <llvm/Support/Signals.h>
+#include <llvm/Support/xxhash.h>
 
+#include <mlir/Bytecode/BytecodeWriter.h>
+#include <mlir/IR/Threading.h>
 #include <mlir/Pass/PassManager.h>
 
 #include <mlir/Target/LLVMIR/Dialect/All.h>
@@ -18,11 +27,15 @@ VAST_UNRELAX_WARNINGS
 #include "vast/CodeGen/CodeGenDriver.hpp"
 
 #include "vast/Util/Common.hpp"
+#include "vast/Util/PipelineStatistics.hpp"
 
+#include "vast/Frontend/CompilationCache.hpp"
 #include "vast/Frontend/Pipelines.hpp"
+#include "vast/Frontend/SharedContext.hpp"
 #include "vast/Frontend/Targets.hpp"
 
 #include "vast/Target/LLVMIR/Convert.hpp"
+#include "vast/Target/LLVMIR/Partition.hpp"
 
 namespace vast::cc {
 
@@ -32,9 +45,51 @@ namespace vast::cc {
 
     void emit_mlir_output(target_dialect target, owning_module_ref mod, mcontext_t *mctx);
 
+    // Measures the enclosing scope as a part of code generation.
+    struct codegen_interval {
+        explicit codegen_interval(std::optional< pipeline_statistics::phase_timer > &timer)
+            : timer(timer)
+        {
+            if (timer) {
+                timer->start();
+            }
+        }
+
+        ~codegen_interval() {
+            if (timer) {
+                timer->stop();
+            }
+        }
+
+        std::optional< pipeline_statistics::phase_timer > &timer;
+    };
+
+    // Options that change how functions are lowered, i.e., the part of the
+    // keys of the compilation cache that identifies the pipeline.
+    static std::string pipeline_configuration(target_dialect target, const vast_args &vargs) {
+        auto disabled = opt::disable("").str();
+
+        std::string configuration = to_string(target);
+        for (string_ref arg : vargs.args) {
+            auto name = arg.drop_front(vast_option_prefix.size());
+            if (name.startswith(disabled) || name.startswith(opt::simplify)
+                || name.startswith(opt::locs_as_meta_ids)
+            ) {
+                configuration += ";" + name.str();
+            }
+        }
+
+        return configuration;
+    }
+
     void vast_consumer::Initialize(acontext_t &actx) {
         VAST_CHECK(!mctx, "initialized multiple times");
-        mctx = std::make_unique< mcontext_t >();
+        if (statistics_enabled()) {
+            codegen_timer.emplace();
+        }
+        codegen_interval measured(codegen_timer);
+
+        mctx = make_mcontext();
         cgctx = std::make_unique< cg::codegen_context >(
             *mctx, actx, get_source_language(opts.lang)
         );
@@ -52,6 +107,7 @@ namespace vast::cc {
             return true;
         }
 
+        codegen_interval measured(codegen_timer);
         return codegen->handle_top_level_decl(decls), true;
     }
 
@@ -71,7 +127,16 @@ namespace vast::cc {
         // Note that this method is called after `HandleTopLevelDecl` has already
         // ran all over the top level decls. Here clang mostly wraps defered and
         // global codegen, followed by running vast passes.
-        codegen->finalize();
+        {
+            codegen_interval measured(codegen_timer);
+            codegen->finalize();
+        }
+
+        if (codegen_timer) {
+            std::size_t ops = 0;
+            cgctx->mod->walk([&] (operation) { ++ops; });
+            codegen_phase = codegen_timer->finish("codegen", ops);
+        }
 
         if (!vargs.has_option(opt::disable_vast_verifier)) {
             if (!codegen->verify_module()) {
@@ -91,6 +156,8 @@ namespace vast::cc {
             return;
         }
 
+        codegen_interval measured(codegen_timer);
+
         // Don't allow re-entrant calls to generator triggered by PCH
         // deserialization to emit deferred decls.
         cg::defer_handle_of_top_level_decl handling_decl(
@@ -114,6 +181,7 @@ namespace vast::cc {
     // }
 
     void vast_consumer::CompleteTentativeDefinition(clang::VarDecl *decl) {
+        codegen_interval measured(codegen_timer);
         codegen->handle_top_level_decl(decl);
     }
 
@@ -131,14 +199,33 @@ namespace vast::cc {
         return std::move(cgctx->mod);
     }
 
+    bool vast_consumer::statistics_enabled() const {
+        return vargs.has_option(opt::time_passes) || vargs.has_option(opt::pass_statistics);
+    }
+
     //
     // vast stream consumer
     //
 
+    bool vast_stream_consumer::needs_locations() const {
+        switch (action) {
+            case output_type::emit_mlir:
+                return vargs.has_option(opt::show_locs) || vargs.has_option(opt::vast_verify_diags);
+            case output_type::none:
+                return false;
+            default:
+                return true;
+        }
+    }
+
     void vast_stream_consumer::HandleTranslationUnit(acontext_t &actx) {
         base::HandleTranslationUnit(actx);
         auto mod = result();
 
+        if (mod && vargs.has_option(opt::lazy_locs) && needs_locations()) {
+            cg::expand_lazy_locations(mod.get(), cgctx->actx.getSourceManager());
+        }
+
         switch (action) {
             case output_type::emit_assembly:
                 return emit_backend_output(
@@ -150,6 +237,12 @@ namespace vast::cc {
                 }
                 VAST_FATAL("no target dialect specified for MLIR output");
             }
+            case output_type::emit_mlir_bytecode: {
+                if (auto trg = vargs.get_option(opt::emit_mlir_bytecode)) {
+                    return emit_mlir_output(parse_target_dialect(trg.value()), std::move(mod), mctx.get());
+                }
+                VAST_FATAL("no target dialect specified for MLIR bytecode output");
+            }
             case output_type::emit_llvm:
                 return emit_backend_output(
                     backend::Backend_EmitLL, std::move(mod), mctx.get()
@@ -168,18 +261,194 @@ namespace vast::cc {
     ) {
         llvm::LLVMContext llvm_context;
 
-        process_mlir_module(target_dialect::llvm, mlir_module.get(), mctx);
+        auto pipeline = process_mlir_module(target_dialect::llvm, mlir_module.get(), mctx);
+        auto stats    = pipeline->statistics;
+
+        auto translation = pipeline_statistics::start_phase();
+        target::llvmir::prepare_module(mlir_module.get());
 
-        auto mod = target::llvmir::translate(mlir_module.get(), llvm_context);
-        auto dl  = cgctx->actx.getTargetInfo().getDataLayoutString();
+        if (emit_partitioned_output(backend_action, mlir_module.get(), mctx, stats)) {
+            return;
+        }
 
+        auto mod = target::llvmir::translate_prepared(mlir_module.get(), llvm_context);
+        if (stats) {
+            std::optional< std::size_t > instructions;
+            if (mod) {
+                instructions = mod->getInstructionCount();
+            }
+            stats->add_phase(pipeline_statistics::finish_phase(
+                "llvm-translation", translation, instructions
+            ));
+        }
+
+        auto dl = cgctx->actx.getTargetInfo().getDataLayoutString();
+
+        auto backend = pipeline_statistics::start_phase();
         clang::EmitBackendOutput(
             opts.diags, opts.headers, opts.codegen, opts.target, opts.lang, dl, mod.get(),
             backend_action, &opts.vfs, std::move(output_stream)
         );
+        if (stats) {
+            stats->add_phase(pipeline_statistics::finish_phase("llvm-backend", backend, std::nullopt));
+        }
+    }
+
+    bool is_backend_reentrant(const clang::CodeGenOptions &opts) {
+        return opts.DebugPass.empty() && opts.LimitFloatPrecision.empty() && !opts.TimePasses;
+    }
+
+    std::uint64_t vast_stream_consumer::unit_hash(string_ref output) const {
+        const auto &sm = cgctx->actx.getSourceManager();
+
+        llvm::SmallString< 256 > unit(output);
+        llvm::sys::fs::make_absolute(unit);
+        unit.push_back('\0');
+
+        if (auto main = sm.getFileEntryRefForID(sm.getMainFileID())) {
+            llvm::SmallString< 256 > main_path(main->getName());
+            llvm::sys::fs::make_absolute(main_path);
+            unit.append(main_path);
+        }
+
+        return llvm::xxHash64(unit.str());
     }
 
-    void vast_stream_consumer::process_mlir_module(
+    unsigned vast_stream_consumer::backend_jobs() const {
+        auto value = vargs.get_option(opt::backend_jobs);
+        if (!value) {
+            return 1;
+        }
+
+        unsigned jobs = 0;
+        if (value->getAsInteger(10, jobs) || jobs == 0) {
+            VAST_FATAL("invalid number of backend jobs: {0}", value.value());
+        }
+        return jobs;
+    }
+
+    bool vast_stream_consumer::emit_partitioned_output(
+        backend backend_action, vast_module mlir_module, mcontext_t *mctx,
+        pipeline_statistics *stats
+    ) {
+        // Outputs of other partitions are named after the output.
+        const auto &output = opts.front.OutputFile;
+        auto jobs = backend_jobs();
+        if (jobs < 2 || output.empty() || output == "-") {
+            return false;
+        }
+
+        // Promoted local symbols must not clash with the ones of other
+        // translation units, their suffix is derived from the output and
+        // the main file, both made absolute.
+        auto partitioning = pipeline_statistics::start_phase();
+        auto suffix = llvm::formatv(".vast.{0:x}", unit_hash(output)).str();
+        auto partitions = target::llvmir::partition_module(mlir_module, jobs, suffix);
+        if (partitions.empty()) {
+            return false;
+        }
+
+        if (stats) {
+            stats->add_phase(pipeline_statistics::finish_phase(
+                "llvm-partitioning", partitioning, std::nullopt
+            ));
+        }
+
+        auto count = partitions.size();
+
+        auto binary = backend_action == backend::Backend_EmitObj
+            || backend_action == backend::Backend_EmitBC;
+
+        std::vector< output_stream_ptr > outputs;
+        outputs.push_back(std::move(output_stream));
+        for (std::size_t idx = 1; idx < count; ++idx) {
+            llvm::SmallString< 128 > path(output);
+            llvm::sys::path::replace_extension(
+                path, llvm::Twine(idx) + llvm::sys::path::extension(output)
+            );
+
+            std::error_code ec;
+            auto os = std::make_unique< llvm::raw_fd_ostream >(
+                path, ec, binary ? llvm::sys::fs::OF_None : llvm::sys::fs::OF_Text
+            );
+            if (ec) {
+                opts.diags.Report(clang::diag::err_fe_unable_to_open_output)
+                    << path.str() << ec.message();
+                return true;
+            }
+            outputs.push_back(std::move(os));
+        }
+
+        // Each partition is translated into its own context, contexts outlive
+        // the modules.
+        std::vector< std::unique_ptr< llvm::LLVMContext > > llvm_contexts(count);
+        std::vector< std::unique_ptr< llvm::Module > > modules(count);
+
+        auto translation = pipeline_statistics::start_phase();
+        mlir::parallelFor(mctx, 0, count, [&] (std::size_t idx) {
+            llvm_contexts[idx] = std::make_unique< llvm::LLVMContext >();
+            modules[idx] = target::llvmir::translate_prepared(
+                partitions[idx].get(), *llvm_contexts[idx]
+            );
+        });
+
+        VAST_CHECK(
+            llvm::all_of(modules, [] (const auto &mod) { return mod != nullptr; }),
+            "failed to translate a module partition to LLVM IR"
+        );
+
+        if (stats) {
+            std::size_t instructions = 0;
+            for (const auto &mod : modules) {
+                instructions += mod->getInstructionCount();
+            }
+            stats->add_phase(pipeline_statistics::finish_phase(
+                "llvm-translation", translation, instructions
+            ));
+        }
+
+        // Diagnostics engine is not thread-safe, partitions report to buffers
+        // that are flushed once the backend finishes.
+        std::vector< std::unique_ptr< clang::TextDiagnosticBuffer > > buffers;
+        std::vector< std::unique_ptr< diagnostics_engine > > diags;
+        for (std::size_t idx = 0; idx < count; ++idx) {
+            auto &buffer = buffers.emplace_back(std::make_unique< clang::TextDiagnosticBuffer >());
+            diags.push_back(std::make_unique< diagnostics_engine >(
+                opts.diags.getDiagnosticIDs(), &opts.diags.getDiagnosticOptions(),
+                buffer.get(), /* owns client */ false
+            ));
+        }
+
+        auto dl = cgctx->actx.getTargetInfo().getDataLayoutString();
+
+        auto emit = [&] (std::size_t idx) {
+            clang::EmitBackendOutput(
+                *diags[idx], opts.headers, opts.codegen, opts.target, opts.lang, dl,
+                modules[idx].get(), backend_action, &opts.vfs, std::move(outputs[idx])
+            );
+        };
+
+        auto backend = pipeline_statistics::start_phase();
+        if (is_backend_reentrant(opts.codegen)) {
+            mlir::parallelFor(mctx, 0, count, emit);
+        } else {
+            for (std::size_t idx = 0; idx < count; ++idx) {
+                emit(idx);
+            }
+        }
+
+        for (const auto &buffer : buffers) {
+            buffer->FlushDiagnostics(opts.diags);
+        }
+
+        if (stats) {
+            stats->add_phase(pipeline_statistics::finish_phase("llvm-backend", backend, std::nullopt));
+        }
+
+        return true;
+    }
+
+    std::unique_ptr< pipeline_t > vast_stream_consumer::process_mlir_module(
         target_dialect target, mlir::ModuleOp mod, mcontext_t *mctx
     ) {
         // Handle source manager properly given that lifetime analysis
@@ -205,12 +474,40 @@ namespace vast::cc {
         }
 
         // Setup and execute vast pipeline
+        // Cached functions are lowered as declarations only, their cached
+        // lowering is spliced once the pipeline finishes.
+        std::optional< compilation_cache > cache;
+        if (auto directory = vargs.get_option(opt::compilation_cache)) {
+            if (target == target_dialect::llvm) {
+                cache.emplace(directory->str(), pipeline_configuration(target, vargs));
+                cache->prepare(mod);
+            }
+        }
+
         auto pipeline = setup_pipeline(pipeline_source::ast, target, *mctx, vargs);
         VAST_CHECK(pipeline, "failed to setup pipeline");
 
+        if (auto stats = pipeline->statistics) {
+            if (codegen_phase) {
+                stats->add_phase(*codegen_phase);
+            }
+            stats->add_counter("codegen.type-cache.hits", cgctx->types.hits);
+            stats->add_counter("codegen.type-cache.misses", cgctx->types.misses);
+            stats->add_counter("codegen.mangle-cache.hits", cgctx->mangler.hits);
+            stats->add_counter("codegen.mangle-cache.misses", cgctx->mangler.misses);
+            if (cache) {
+                stats->add_counter("compilation-cache.hits", cache->hits);
+                stats->add_counter("compilation-cache.misses", cache->misses);
+            }
+        }
+
         auto result = pipeline->run(mod);
         VAST_CHECK(mlir::succeeded(result), "MLIR pass manager failed when running vast passes");
 
+        if (cache && mlir::failed(cache->finish(mod))) {
+            VAST_FATAL("module verification error after splicing cached functions");
+        }
+
         // Verify the diagnostic handler to make sure that each of the
         // diagnostics matched.
         if (verify_diagnostics && src_mgr_handler.verify().failed()) {
@@ -222,6 +519,8 @@ namespace vast::cc {
         // if (!vargs.has_option(opt::disable_emit_cxx_default)) {
         //     generator->build_default_methods();
         // }
+
+        return pipeline;
     }
 
     void vast_stream_consumer::emit_mlir_output(
@@ -233,6 +532,16 @@ namespace vast::cc {
 
         process_mlir_module(target, mod.get(), mctx);
 
+        if (action == output_type::emit_mlir_bytecode) {
+            // Bodies of functions are isolated from above, hence the writer
+            // makes them lazily loadable.
+            mlir::BytecodeWriterConfig config("VAST");
+            if (mlir::failed(mlir::writeBytecodeToFile(mod.get(), *output_stream, config))) {
+                VAST_FATAL("failed to write MLIR bytecode");
+            }
+            return;
+        }
+
         // FIXME: we cannot roundtrip prettyForm=true right now.
         mlir::OpPrintingFlags flags;
         flags.enableDebugInfo(vargs.has_option(opt::show_locs), /* prettyForm */ true);
@@ -5,6 +5,9 @@
 #include "vast/Dialect/HighLevel/Passes.hpp"
 #include "vast/Conversion/Passes.hpp"
 
+#include "vast/Util/PatternProfile.hpp"
+#include "vast/Util/PipelineStatistics.hpp"
+
 namespace vast::cc {
 
     namespace pipeline {
@@ -24,6 +27,13 @@ namespace vast::cc {
             );
         }
 
+        // Folds constants and merges common subexpressions of high level MLIR
+        pipeline_step_ptr fold_high_level() {
+            return compose("fold",
+                hl::pipeline::fold
+            );
+        }
+
         // Generates MLIR with standard types
         pipeline_step_ptr standard_types() {
             return compose("standard-types",
@@ -79,6 +89,10 @@ namespace vast::cc {
                 co_return;
             }
 
+            if (simplify) {
+                path.front().second.push_back(fold_high_level);
+            }
+
             for (const auto &[dialect, step_passes] : path) {
                 for (auto &step : step_passes) {
                     auto pipeline_step = step();
@@ -132,6 +146,37 @@ namespace vast::cc {
             passes->dump();
         }
 
+        // Statistics are attributed to steps, hence they need to be set up
+        // after all steps are scheduled.
+        bool time_passes = vargs.has_option(opt::time_passes);
+        auto statistics_path = vargs.get_option(opt::pass_statistics);
+        if (time_passes || vargs.has_option(opt::pass_statistics)) {
+            VAST_CHECK(!vargs.has_option(opt::pass_statistics) || statistics_path.has_value(),
+                "expected path to pass statistics file"
+            );
+
+            std::optional< std::string > json_path;
+            if (statistics_path) {
+                json_path = statistics_path->str();
+            }
+
+            auto statistics = std::make_unique< pipeline_statistics >(
+                *passes, time_passes, std::move(json_path)
+            );
+            passes->statistics = statistics.get();
+            passes->addInstrumentation(std::move(statistics));
+        }
+
+        // Patterns are wrapped when passes populate them, i.e., once the
+        // pipeline runs, hence the profile only needs to be active by then.
+        if (vargs.has_option(opt::profile_patterns)) {
+            std::optional< std::string > json_path;
+            if (auto path = vargs.get_option(opt::profile_patterns)) {
+                json_path = path->str();
+            }
+            passes->addInstrumentation(std::make_unique< pattern_profiler >(std::move(json_path)));
+        }
+
         if (vargs.has_option(opt::disable_multithreading) || vargs.has_option(opt::emit_crash_reproducer)) {
             mctx.disableMultithreading();
         }
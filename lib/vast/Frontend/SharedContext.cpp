@@ -0,0 +1,39 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#include "vast/Frontend/SharedContext.hpp"
+
+#include "vast/Dialect/Dialects.hpp"
+#include "vast/Target/LLVMIR/Convert.hpp"
+
+namespace vast::cc {
+
+    namespace {
+        shared_context_state *shared_state = nullptr;
+    } // namespace
+
+    shared_context_state::shared_context_state(llvm::ThreadPoolStrategy strategy)
+        : pool(strategy)
+    {
+        vast::registerDefaultDialects(registry);
+        target::llvmir::register_vast_to_llvm_ir(registry);
+    }
+
+    void set_shared_context_state(shared_context_state *state) {
+        shared_state = state;
+    }
+
+    std::unique_ptr< mcontext_t > make_mcontext() {
+        if (!shared_state) {
+            return std::make_unique< mcontext_t >();
+        }
+
+        // The context has to be created without threading to be able to
+        // attach the external thread pool.
+        auto mctx = std::make_unique< mcontext_t >(
+            shared_state->registry, mcontext_t::Threading::DISABLED
+        );
+        mctx->setThreadPool(shared_state->pool);
+        return mctx;
+    }
+
+} // namespace vast::cc
@@ -67,15 +67,22 @@ namespace vast::target::llvmir
             );
         } ();
 
+        // VAST keeps the layout hashed under its own name, the translation
+        // expects the plain `dlti` form.
+        for (auto attr : mlir_module->getAttrs()) {
+            if (mlir::isa< mlir::DataLayoutSpecInterface >(attr.getValue())) {
+                mlir_module->removeAttr(attr.getName());
+                break;
+            }
+        }
+
         mlir_module->setAttr(
             mlir::DLTIDialect::kDataLayoutAttrName,
             mlir::DataLayoutSpecAttr::get(mlir_module.getContext(), filtered_entries)
         );
     }
 
-    std::unique_ptr< llvm::Module > translate(
-        vast_module mlir_module, llvm::LLVMContext &llvm_ctx
-    ) {
+    void prepare_module(vast_module mlir_module) {
         clean_up_data_layout(mlir_module);
 
         // TODO move to LLVM conversion and use attr replacer
@@ -87,10 +94,21 @@ namespace vast::target::llvmir
 
         mlir::registerBuiltinDialectTranslation(*mlir_module.getContext());
         mlir::registerLLVMDialectTranslation(*mlir_module.getContext());
+    }
 
+    std::unique_ptr< llvm::Module > translate_prepared(
+        vast_module mlir_module, llvm::LLVMContext &llvm_ctx
+    ) {
         return mlir::translateModuleToLLVMIR(mlir_module, llvm_ctx);
     }
 
+    std::unique_ptr< llvm::Module > translate(
+        vast_module mlir_module, llvm::LLVMContext &llvm_ctx
+    ) {
+        prepare_module(mlir_module);
+        return translate_prepared(mlir_module, llvm_ctx);
+    }
+
     void register_vast_to_llvm_ir(mlir::DialectRegistry &registry)
     {
         registry.insert< hl::HighLevelDialect >();
@@ -0,0 +1,364 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#include "vast/Target/LLVMIR/Partition.hpp"
+
+VAST_RELAX_WARNINGS
+#include <mlir/Dialect/LLVMIR/LLVMDialect.h>
+#include <mlir/IR/AttrTypeSubElements.h>
+#include <mlir/IR/Builders.h>
+#include <mlir/IR/BuiltinOps.h>
+#include <mlir/IR/SymbolTable.h>
+
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/DenseSet.h>
+#include <llvm/ADT/SmallVector.h>
+VAST_UNRELAX_WARNINGS
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+
+namespace vast::target::llvmir
+{
+    namespace
+    {
+        namespace LLVM = mlir::LLVM;
+
+        // Owner of operations that are kept in every partition.
+        constexpr unsigned everywhere = std::numeric_limits< unsigned >::max();
+
+        bool is_local(LLVM::Linkage linkage) {
+            return linkage == LLVM::Linkage::Private || linkage == LLVM::Linkage::Internal;
+        }
+
+        // Copies of the same definition are merged by the linker.
+        bool is_mergeable(LLVM::Linkage linkage) {
+            switch (linkage) {
+                case LLVM::Linkage::AvailableExternally:
+                case LLVM::Linkage::Linkonce:
+                case LLVM::Linkage::LinkonceODR:
+                case LLVM::Linkage::Weak:
+                case LLVM::Linkage::WeakODR:
+                case LLVM::Linkage::Common:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        std::optional< LLVM::Linkage > linkage_of(operation op) {
+            if (auto fn = mlir::dyn_cast< LLVM::LLVMFuncOp >(op)) {
+                return fn.getLinkage();
+            }
+            if (auto global = mlir::dyn_cast< LLVM::GlobalOp >(op)) {
+                return global.getLinkage();
+            }
+            return std::nullopt;
+        }
+
+        void set_linkage(operation op, LLVM::Linkage linkage) {
+            auto attr = LLVM::LinkageAttr::get(op->getContext(), linkage);
+            if (auto fn = mlir::dyn_cast< LLVM::LLVMFuncOp >(op)) {
+                return fn.setLinkageAttr(attr);
+            }
+            mlir::cast< LLVM::GlobalOp >(op).setLinkageAttr(attr);
+        }
+
+        void set_hidden(operation op) {
+            if (auto fn = mlir::dyn_cast< LLVM::LLVMFuncOp >(op)) {
+                return fn.setVisibility_(LLVM::Visibility::Hidden);
+            }
+            mlir::cast< LLVM::GlobalOp >(op).setVisibility_(LLVM::Visibility::Hidden);
+        }
+
+        bool is_definition(operation op) {
+            if (auto fn = mlir::dyn_cast< LLVM::LLVMFuncOp >(op)) {
+                return !fn.isExternal();
+            }
+            if (auto global = mlir::dyn_cast< LLVM::GlobalOp >(op)) {
+                return global.getValueAttr() || !global.getInitializerRegion().empty();
+            }
+            return false;
+        }
+
+        // Declaration of a definition owned by another partition.
+        operation make_declaration(mlir::OpBuilder &bld, operation def) {
+            auto decl = bld.insert(def->cloneWithoutRegions());
+            if (auto global = mlir::dyn_cast< LLVM::GlobalOp >(decl)) {
+                global.removeValueAttr();
+            }
+            // Declarations cannot be members of comdats.
+            decl->removeAttr("comdat");
+            set_linkage(decl, LLVM::Linkage::External);
+            return decl;
+        }
+
+        std::size_t size_of(operation op) {
+            std::size_t size = 0;
+            op->walk([&] (operation) { ++size; });
+            return size;
+        }
+
+        struct partitioner
+        {
+            vast_module mod;
+            unsigned count;
+            string_ref unique_suffix;
+
+            std::vector< operation > top;
+            llvm::DenseMap< operation, unsigned > owner;
+
+            // Module level operations referring to each function or global,
+            // and functions or globals referred to by each operation.
+            llvm::DenseMap< operation, llvm::SmallVector< operation, 4 > > users;
+            llvm::DenseMap< operation, llvm::SmallVector< operation, 4 > > uses;
+
+            // Local functions copied to each partition besides their owner.
+            std::vector< llvm::DenseSet< operation > > copies;
+
+            std::vector< owning_module_ref > run() {
+                for (auto &op : mod.getBody()->getOperations()) {
+                    top.push_back(&op);
+                }
+
+                if (!distribute_functions()) {
+                    return {};
+                }
+
+                collect_users();
+                assign_globals();
+                copy_local_functions();
+                promote_shared_locals();
+
+                std::vector< owning_module_ref > partitions;
+                for (unsigned idx = 0; idx < count; ++idx) {
+                    partitions.push_back(make_partition(idx));
+                }
+                return partitions;
+            }
+
+            // Greedily assigns the largest remaining function to the least
+            // loaded partition.
+            bool distribute_functions() {
+                std::vector< std::pair< operation, std::size_t > > functions;
+                for (auto op : top) {
+                    auto linkage = linkage_of(op);
+                    if (!linkage || !is_definition(op)) {
+                        continue;
+                    }
+
+                    if (is_mergeable(*linkage)) {
+                        owner[op] = everywhere;
+                    } else if (mlir::isa< LLVM::LLVMFuncOp >(op)) {
+                        functions.emplace_back(op, size_of(op));
+                    }
+                }
+
+                if (functions.size() < 2) {
+                    return false;
+                }
+
+                count = std::min< unsigned >(count, functions.size());
+
+                std::stable_sort(functions.begin(), functions.end(), [] (auto &a, auto &b) {
+                    return a.second > b.second;
+                });
+
+                std::vector< std::size_t > load(count, 0);
+                for (const auto &[fn, size] : functions) {
+                    auto lightest = std::min_element(load.begin(), load.end());
+                    owner[fn] = static_cast< unsigned >(std::distance(load.begin(), lightest));
+                    *lightest += size;
+                }
+
+                return true;
+            }
+
+            void collect_users() {
+                mlir::SymbolTable table(mod);
+                for (auto op : top) {
+                    op->walk([&] (operation nested) {
+                        nested->getAttrDictionary().walk([&] (mlir::SymbolRefAttr ref) {
+                            auto symbol = table.lookup(ref.getRootReference());
+                            if (symbol && symbol != op) {
+                                users[symbol].push_back(op);
+                                uses[op].push_back(symbol);
+                            }
+                        });
+                    });
+                }
+            }
+
+            unsigned owner_of(operation op) const {
+                if (auto it = owner.find(op); it != owner.end()) {
+                    return it->second;
+                }
+
+                // Global constructors and destructors are registered once.
+                if (mlir::isa< LLVM::GlobalCtorsOp, LLVM::GlobalDtorsOp >(op)) {
+                    return 0;
+                }
+
+                // Declarations and other module level operations.
+                if (!is_definition(op)) {
+                    return everywhere;
+                }
+
+                return 0;
+            }
+
+            // Globals are defined next to their users if they are all in the
+            // same partition.
+            void assign_globals() {
+                for (auto op : top) {
+                    if (!mlir::isa< LLVM::GlobalOp >(op) || owner.count(op) || !is_definition(op)) {
+                        continue;
+                    }
+
+                    std::optional< unsigned > common;
+                    for (auto user : users.lookup(op)) {
+                        auto user_owner = mlir::isa< LLVM::LLVMFuncOp >(user) ? owner_of(user) : 0;
+                        if (!common) {
+                            common = user_owner;
+                        } else if (*common != user_owner) {
+                            common = 0;
+                        }
+                    }
+
+                    owner[op] = common && *common != everywhere ? *common : 0;
+                }
+            }
+
+            bool is_local_function(operation op) const {
+                auto linkage = linkage_of(op);
+                return mlir::isa< LLVM::LLVMFuncOp >(op) && is_local(*linkage) && is_definition(op);
+            }
+
+            bool is_present(operation op, unsigned idx) const {
+                auto op_owner = owner_of(op);
+                return op_owner == everywhere || op_owner == idx || copies[idx].contains(op);
+            }
+
+            // Local functions keep their linkage and are copied to every
+            // partition that refers to them, so that the optimizer can still
+            // inline them.
+            void copy_local_functions() {
+                copies.resize(count);
+                for (unsigned idx = 0; idx < count; ++idx) {
+                    std::vector< operation > worklist;
+                    for (auto op : top) {
+                        auto op_owner = owner_of(op);
+                        if (op_owner == everywhere || op_owner == idx) {
+                            worklist.push_back(op);
+                        }
+                    }
+
+                    while (!worklist.empty()) {
+                        auto op = worklist.back();
+                        worklist.pop_back();
+                        for (auto used : uses.lookup(op)) {
+                            if (!is_local_function(used) || is_present(used, idx)) {
+                                continue;
+                            }
+                            copies[idx].insert(used);
+                            worklist.push_back(used);
+                        }
+                    }
+                }
+            }
+
+            // Local globals used across partitions are made external and
+            // hidden. Uses are renamed by a single walk of the module.
+            void promote_shared_locals() {
+                auto ctx = mod.getContext();
+
+                llvm::DenseMap< mlir::StringAttr, mlir::StringAttr > renames;
+                for (auto op : top) {
+                    auto linkage = linkage_of(op);
+                    if (!linkage || !is_local(*linkage) || !is_definition(op)) {
+                        continue;
+                    }
+
+                    if (mlir::isa< LLVM::LLVMFuncOp >(op)) {
+                        continue;
+                    }
+
+                    auto def_owner = owner_of(op);
+                    auto is_shared = llvm::any_of(users.lookup(op), [&] (operation user) {
+                        for (unsigned idx = 0; idx < count; ++idx) {
+                            if (idx != def_owner && is_present(user, idx)) {
+                                return true;
+                            }
+                        }
+                        return false;
+                    });
+
+                    if (!is_shared) {
+                        continue;
+                    }
+
+                    auto name = mlir::SymbolTable::getSymbolName(op);
+                    auto promoted = mlir::StringAttr::get(ctx, name.getValue() + unique_suffix);
+                    renames[name] = promoted;
+                    mlir::SymbolTable::setSymbolName(op, promoted);
+
+                    set_linkage(op, LLVM::Linkage::External);
+                    set_hidden(op);
+                }
+
+                if (renames.empty()) {
+                    return;
+                }
+
+                mlir::AttrTypeReplacer replacer;
+                replacer.addReplacement([&] (mlir::SymbolRefAttr ref) -> std::optional< mlir::Attribute > {
+                    if (auto it = renames.find(ref.getRootReference()); it != renames.end()) {
+                        return mlir::SymbolRefAttr::get(it->second, ref.getNestedReferences());
+                    }
+                    return std::nullopt;
+                });
+
+                replacer.recursivelyReplaceElementsIn(
+                    mod
+                    , true /* replace attrs */
+                    , false /* replace locs */
+                    , false /* replace types */
+                );
+            }
+
+            owning_module_ref make_partition(unsigned idx) {
+                auto part = vast_module::create(mod.getLoc());
+                part->setAttrs(mod->getAttrDictionary());
+
+                auto bld = mlir::OpBuilder::atBlockEnd(part.getBody());
+                for (auto op : top) {
+                    auto op_owner = owner_of(op);
+                    if (op_owner == everywhere || op_owner == idx || copies[idx].contains(op)) {
+                        bld.clone(*op);
+                        continue;
+                    }
+
+                    // Local symbols left local are not used by this partition.
+                    auto linkage = linkage_of(op);
+                    if (linkage && !is_local(*linkage)) {
+                        make_declaration(bld, op);
+                    }
+                }
+
+                return part;
+            }
+        };
+
+    } // namespace
+
+    std::vector< owning_module_ref > partition_module(
+        vast_module mod, unsigned count, string_ref unique_suffix
+    ) {
+        if (count < 2) {
+            return {};
+        }
+
+        return partitioner{ mod, count, unique_suffix }.run();
+    }
+
+} // namespace vast::target::llvmir
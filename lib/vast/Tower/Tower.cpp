@@ -2,21 +2,246 @@
 
 #include "vast/Tower/Tower.hpp"
 
+VAST_RELAX_WARNINGS
+#include <mlir/IR/Location.h>
+#include <mlir/IR/OperationSupport.h>
+#include <mlir/IR/SymbolTable.h>
+VAST_UNRELAX_WARNINGS
+
 namespace vast::tw {
-    auto default_loc_rewriter_t::insert(mlir::Operation *op) -> void {
-        auto ctx = op->getContext();
-        auto ol  = mlir::OpaqueLoc::get< mlir::Operation  *>(op, ctx);
-        op->setLoc(mlir::FusedLoc::get({ op->getLoc() }, ol, ctx));
+
+    namespace {
+
+        using function_t = mlir::FunctionOpInterface;
+
+        auto function_name(function_t fn) -> string_ref {
+            return mlir::SymbolTable::getSymbolName(fn).getValue();
+        }
+
+        // Visits functions of the module without entering their bodies.
+        auto for_each_function(vast_module mod, auto &&yield) -> void {
+            mod->walk< mlir::WalkOrder::PreOrder >([&] (operation op) {
+                if (auto fn = mlir::dyn_cast< function_t >(op)) {
+                    yield(fn);
+                    return mlir::WalkResult::skip();
+                }
+                return mlir::WalkResult::advance();
+            });
+        }
+
+        auto find_function(vast_module mod, string_ref name) -> function_t {
+            function_t result;
+            for_each_function(mod, [&] (function_t fn) {
+                if (!result && function_name(fn) == name) {
+                    result = fn;
+                }
+            });
+            return result;
+        }
+
+        // Functions with unique names, others are never shared.
+        auto unique_functions(vast_module mod) -> llvm::StringMap< function_t > {
+            llvm::StringMap< function_t > functions;
+            llvm::StringSet<> duplicates;
+            for_each_function(mod, [&] (function_t fn) {
+                auto name = function_name(fn);
+                if (!functions.try_emplace(name, fn).second) {
+                    duplicates.insert(name);
+                }
+            });
+
+            for (const auto &name : duplicates) {
+                functions.erase(name.getKey());
+            }
+
+            return functions;
+        }
+
+        auto body_operations(function_t fn) -> std::vector< operation > {
+            std::vector< operation > ops;
+            fn.getFunctionBody().walk([&] (operation op) { ops.push_back(op); });
+            return ops;
+        }
+
+        // Links are recorded from the clone mapping and are not updated by the
+        // pipeline, hence an erased operation might leave behind a link that
+        // a new operation at the same address inherits. Such links are told
+        // apart by the operation they refer to.
+        auto is_clone_of(operation op, operation origin) -> bool {
+            return op->getName() == origin->getName() && op->getLoc() == origin->getLoc();
+        }
+
+    } // namespace
+
+    auto tower::apply(handle_t handle, mlir::PassManager &pm) -> handle_t {
+        materialize(handle);
+
+        mlir::IRMapping mapping;
+        auto mod = mlir::cast< vast_module >(handle.mod->clone(mapping));
+
+        level_t child{ .mod = owning_module_ref(mod), .parent = handle.id };
+        for (auto [from, to] : mapping.getOperationMap()) {
+            child.links[to] = from;
+        }
+
+        if (mlir::failed(pm.run(mod))) {
+            VAST_FATAL("some pass in apply() failed");
+        }
+
+        // The previous top level is frozen from now on, hence it can share
+        // bodies with its parent.
+        auto frozen = _levels.size() - 1;
+
+        _levels.push_back(std::move(child));
+        auto id = _levels.size() - 1;
+        ++_levels[handle.id].children;
+
+        // Bodies can be shared only with a single child, otherwise links of
+        // the other children would dangle.
+        if (auto parent = _levels[frozen].parent) {
+            if (_levels[*parent].children == 1) {
+                share_functions(*parent, frozen);
+            }
+        }
+
+        return { id, mod };
     }
 
-    auto default_loc_rewriter_t::remove(mlir::Operation *op) -> void {
-        auto fl = mlir::cast< mlir::FusedLoc >(op->getLoc());
-        op->setLoc(fl.getLocations().front());
+    auto tower::share_functions(std::size_t parent, std::size_t child) -> void {
+        auto parent_functions = unique_functions(_levels[parent].mod.get());
+
+        for (const auto &[name, fn] : unique_functions(_levels[child].mod.get())) {
+            auto it = parent_functions.find(name);
+            if (it == parent_functions.end()) {
+                continue;
+            }
+
+            auto parent_fn = it->second;
+            if (parent_fn.isExternal()) {
+                continue;
+            }
+
+            if (!mlir::OperationEquivalence::isEquivalentTo(
+                fn, parent_fn, mlir::OperationEquivalence::Flags::None
+            )) {
+                continue;
+            }
+
+            // Links of the child body would refer to the dropped parent body.
+            for (auto op : body_operations(fn)) {
+                _levels[child].links.erase(op);
+            }
+            _levels[child].unresolved.insert(name);
+
+            drop_body(parent, parent_fn);
+            _levels[parent].stubs[name] = child;
+        }
     }
 
-    auto default_loc_rewriter_t::prev(mlir::Operation *op) -> mlir::Operation * {
-        auto fl = mlir::cast< mlir::FusedLoc >(op->getLoc());
-        auto ol = mlir::cast< mlir::OpaqueLoc >(fl.getMetadata());
-        return mlir::OpaqueLoc::getUnderlyingLocation< mlir::Operation * >(ol);
+    auto tower::drop_body(std::size_t id, function_t fn) -> void {
+        auto &level = _levels[id];
+        for (auto op : body_operations(fn)) {
+            level.links.erase(op);
+        }
+
+        if (level.parent) {
+            level.unresolved.insert(function_name(fn));
+        }
+
+        auto &body = fn.getFunctionBody();
+        body.dropAllReferences();
+        body.getBlocks().clear();
     }
+
+    auto tower::materialize(handle_t handle) -> void {
+        llvm::SmallVector< std::string > stubs;
+        for (const auto &stub : _levels[handle.id].stubs) {
+            stubs.push_back(stub.getKey().str());
+        }
+
+        for (const auto &name : stubs) {
+            materialize(handle.id, name);
+        }
+    }
+
+    auto tower::materialize(std::size_t id, string_ref name) -> void {
+        auto it = _levels[id].stubs.find(name);
+        if (it == _levels[id].stubs.end()) {
+            return;
+        }
+
+        auto donor = it->second;
+        _levels[id].stubs.erase(it);
+
+        // The donor might have shared the body with its own child.
+        materialize(donor, name);
+
+        auto fn     = find_function(_levels[id].mod.get(), name);
+        auto source = find_function(_levels[donor].mod.get(), name);
+        VAST_CHECK(fn && source, "missing shared function {0}", name);
+
+        mlir::IRMapping mapping;
+        source.getFunctionBody().cloneInto(&fn.getFunctionBody(), mapping);
+    }
+
+    auto tower::resolve_links(std::size_t id, string_ref name) -> void {
+        auto &level = _levels[id];
+        if (!level.unresolved.erase(name)) {
+            return;
+        }
+
+        auto parent = level.parent.value();
+        materialize(parent, name);
+
+        auto fn        = find_function(level.mod.get(), name);
+        auto parent_fn = find_function(_levels[parent].mod.get(), name);
+        VAST_CHECK(fn && parent_fn, "missing shared function {0}", name);
+
+        // Bodies are equivalent, hence they match operation by operation.
+        auto ops        = body_operations(fn);
+        auto parent_ops = body_operations(parent_fn);
+        VAST_CHECK(ops.size() == parent_ops.size(), "shared function {0} diverged", name);
+
+        for (auto [op, parent_op] : llvm::zip(ops, parent_ops)) {
+            level.links[op] = parent_op;
+        }
+    }
+
+    auto tower::level(std::size_t id) -> handle_t {
+        VAST_CHECK(id < _levels.size(), "unknown tower level {0}", id);
+        return { id, _levels[id].mod.get() };
+    }
+
+    auto tower::parent(handle_t handle) -> std::optional< handle_t > {
+        if (auto parent = _levels[handle.id].parent) {
+            return level(*parent);
+        }
+        return std::nullopt;
+    }
+
+    auto tower::is_shared(handle_t handle, string_ref fn) const -> bool {
+        return _levels[handle.id].stubs.contains(fn);
+    }
+
+    auto tower::prev(handle_t handle, operation op) -> operation {
+        auto &level = _levels[handle.id];
+        if (auto it = level.links.find(op); it != level.links.end()) {
+            if (is_clone_of(op, it->second)) {
+                return it->second;
+            }
+            level.links.erase(it);
+            return nullptr;
+        }
+
+        if (auto fn = op->getParentOfType< function_t >()) {
+            auto name = function_name(fn);
+            if (level.unresolved.contains(name)) {
+                resolve_links(handle.id, name);
+                return level.links.lookup(op);
+            }
+        }
+
+        return nullptr;
+    }
+
 } // namespace vast::tw
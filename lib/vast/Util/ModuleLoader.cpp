@@ -0,0 +1,94 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#include "vast/Util/ModuleLoader.hpp"
+
+VAST_RELAX_WARNINGS
+#include <mlir/Bytecode/BytecodeReader.h>
+#include <mlir/IR/Diagnostics.h>
+#include <mlir/Interfaces/FunctionInterfaces.h>
+#include <mlir/Parser/Parser.h>
+VAST_UNRELAX_WARNINGS
+
+namespace vast {
+
+    namespace {
+
+        // Everything but functions is materialized as soon as it is reached,
+        // e.g., translation units, that are isolated from above as well.
+        bool materialize_eagerly(operation op) {
+            return !mlir::isa< mlir::FunctionOpInterface >(op);
+        }
+
+    } // namespace
+
+    module_loader::module_loader(mcontext_t &mctx, memory_buffer buffer, bool lazy)
+        : mctx(mctx), source_mgr(std::make_shared< llvm::SourceMgr >())
+    {
+        auto ref = buffer->getMemBufferRef();
+        source_mgr->AddNewSourceBuffer(std::move(buffer), llvm::SMLoc());
+
+        mlir::SourceMgrDiagnosticHandler handler(*source_mgr, &mctx);
+        mlir::ParserConfig config(&mctx);
+
+        if (!lazy || !mlir::isBytecode(ref)) {
+            mod = mlir::parseSourceFile< vast_module >(*source_mgr, config);
+            return;
+        }
+
+        reader = std::make_unique< mlir::BytecodeReader >(
+            ref, config, /* lazyLoad */ true, source_mgr
+        );
+
+        mlir::Block block;
+        if (mlir::failed(reader->readTopLevel(&block, materialize_eagerly))) {
+            reader.reset();
+            return;
+        }
+
+        auto top = llvm::hasSingleElement(block)
+            ? mlir::dyn_cast< vast_module >(&block.front())
+            : vast_module();
+        if (!top) {
+            mlir::emitError(mlir::UnknownLoc::get(&mctx), "expected a single top-level module");
+            reader.reset();
+            return;
+        }
+
+        top->remove();
+        mod = top;
+    }
+
+    module_loader::~module_loader() = default;
+
+    owning_module_ref module_loader::take() {
+        if (mlir::failed(materialize_all())) {
+            return {};
+        }
+        return std::move(mod);
+    }
+
+    bool module_loader::is_materializable(operation op) {
+        return op && reader && reader->isMaterializable(op);
+    }
+
+    logical_result module_loader::materialize(operation op) {
+        if (!is_materializable(op)) {
+            return mlir::success();
+        }
+
+        mlir::SourceMgrDiagnosticHandler handler(*source_mgr, &mctx);
+        return reader->materialize(op, materialize_eagerly);
+    }
+
+    logical_result module_loader::materialize_all() {
+        if (!reader) {
+            return mlir::success();
+        }
+
+        mlir::SourceMgrDiagnosticHandler handler(*source_mgr, &mctx);
+        auto result = reader->finalize();
+        reader.reset();
+        return result;
+    }
+
+} // namespace vast
@@ -0,0 +1,157 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#include "vast/Util/PatternProfile.hpp"
+
+VAST_RELAX_WARNINGS
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Format.h>
+#include <llvm/Support/JSON.h>
+VAST_UNRELAX_WARNINGS
+
+#include <algorithm>
+
+namespace vast {
+
+    namespace {
+
+        double milliseconds(pattern_profile::clock::duration duration) {
+            return std::chrono::duration< double, std::milli >(duration).count();
+        }
+
+    } // namespace
+
+    std::atomic< pattern_profile * > pattern_profile::current = nullptr;
+
+    void pattern_profile::add(
+        string_ref pattern, string_ref root, bool success, clock::duration time
+    ) {
+        auto key = (pattern + "@" + root).str();
+
+        std::lock_guard< std::mutex > lock(mutex);
+        auto [it, inserted] = record_idx.try_emplace(key, records.size());
+        if (inserted) {
+            records.push_back({ .pattern = pattern.str(), .root = root.str() });
+        }
+
+        auto &rec = records[it->second];
+        if (success) {
+            ++rec.successes;
+        } else {
+            ++rec.failures;
+        }
+        rec.time += time;
+    }
+
+    auto pattern_profile::sorted_records() const -> std::vector< record > {
+        std::vector< record > sorted;
+        {
+            std::lock_guard< std::mutex > lock(mutex);
+            sorted = records;
+        }
+
+        std::stable_sort(sorted.begin(), sorted.end(), [] (const auto &a, const auto &b) {
+            return a.time > b.time;
+        });
+        return sorted;
+    }
+
+    void pattern_profile::print_table(llvm::raw_ostream &os) const {
+        os << "===" << std::string(73, '-') << "===\n"
+           << "                          VAST pattern profile\n"
+           << "===" << std::string(73, '-') << "===\n";
+
+        os << llvm::format("  %10s  %10s  %10s  %10s  %s\n",
+            "Time (ms)", "Attempts", "Successes", "Failures", "Pattern (root)"
+        );
+
+        for (const auto &rec : sorted_records()) {
+            os << llvm::format("  %10.4f  %10llu  %10llu  %10llu  %s (%s)\n",
+                milliseconds(rec.time),
+                static_cast< unsigned long long >(rec.attempts()),
+                static_cast< unsigned long long >(rec.successes),
+                static_cast< unsigned long long >(rec.failures),
+                rec.pattern.c_str(),
+                rec.root.c_str()
+            );
+        }
+    }
+
+    void pattern_profile::print_json(llvm::raw_ostream &os) const {
+        llvm::json::OStream json(os, /* indent */ 2);
+
+        auto records = sorted_records();
+
+        // Totals of patterns in order of their most expensive root.
+        std::vector< record > patterns;
+        llvm::StringMap< std::size_t > pattern_idx;
+        for (const auto &rec : records) {
+            auto [it, inserted] = pattern_idx.try_emplace(rec.pattern, patterns.size());
+            if (inserted) {
+                patterns.push_back({ .pattern = rec.pattern });
+            }
+            auto &total = patterns[it->second];
+            total.successes += rec.successes;
+            total.failures  += rec.failures;
+            total.time      += rec.time;
+        }
+
+        auto counts = [&] (const record &rec) {
+            json.attribute("attempts", static_cast< std::int64_t >(rec.attempts()));
+            json.attribute("successes", static_cast< std::int64_t >(rec.successes));
+            json.attribute("failures", static_cast< std::int64_t >(rec.failures));
+            json.attribute("time_ms", milliseconds(rec.time));
+        };
+
+        json.object([&] {
+            json.attributeArray("patterns", [&] {
+                for (const auto &total : patterns) {
+                    json.object([&] {
+                        json.attribute("name", total.pattern);
+                        counts(total);
+                        json.attributeArray("roots", [&] {
+                            for (const auto &rec : records) {
+                                if (rec.pattern != total.pattern) {
+                                    continue;
+                                }
+                                json.object([&] {
+                                    json.attribute("name", rec.root);
+                                    counts(rec);
+                                });
+                            }
+                        });
+                    });
+                }
+            });
+        });
+        os << "\n";
+    }
+
+    pattern_profiler::pattern_profiler(std::optional< std::string > json_path)
+        : json_path(std::move(json_path))
+    {
+        pattern_profile *expected = nullptr;
+        owns_profile = current.compare_exchange_strong(expected, this, std::memory_order_acq_rel);
+    }
+
+    pattern_profiler::~pattern_profiler() {
+        if (!owns_profile) {
+            return;
+        }
+
+        current.store(nullptr, std::memory_order_release);
+
+        if (!json_path) {
+            return print_table(llvm::errs());
+        }
+
+        std::error_code ec;
+        llvm::raw_fd_ostream os(*json_path, ec, llvm::sys::fs::OF_Text);
+        if (ec) {
+            llvm::errs() << "error: cannot open pattern profile file '"
+                         << *json_path << "': " << ec.message() << "\n";
+            return;
+        }
+        print_json(os);
+    }
+
+} // namespace vast
@@ -12,6 +12,7 @@ namespace vast {
         }
 
         seen.insert(id);
+        enclosing_steps[pass.get()] = scheduled_steps;
         base::addPass(std::move(pass));
     }
 
@@ -38,10 +39,12 @@ namespace vast {
     }
 
     void compound_pipeline_step::schedule_on(pipeline_t &ppl) const {
+        ppl.scheduled_steps.push_back(pipeline_name);
         schedule_dependencies(ppl);
         for (const auto &step : steps) {
             step()->schedule_on(ppl);
         }
+        ppl.scheduled_steps.pop_back();
     }
 
     string_ref compound_pipeline_step::name() const {
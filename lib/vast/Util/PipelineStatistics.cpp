@@ -0,0 +1,362 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#include "vast/Util/PipelineStatistics.hpp"
+
+VAST_RELAX_WARNINGS
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Format.h>
+#include <llvm/Support/JSON.h>
+#include <llvm/Support/Process.h>
+#include <mlir/IR/Location.h>
+VAST_UNRELAX_WARNINGS
+
+#include <ctime>
+#include <fstream>
+
+namespace vast {
+
+    namespace {
+
+        std::int64_t resident_memory() {
+        #if defined(__linux__)
+            std::ifstream statm("/proc/self/statm");
+            std::int64_t size = 0, resident = 0;
+            if (statm >> size >> resident) {
+                return resident * llvm::sys::Process::getPageSizeEstimate();
+            }
+        #endif
+            // Fallback to the heap usage if resident set size is unavailable.
+            return static_cast< std::int64_t >(llvm::sys::Process::GetMallocUsage());
+        }
+
+        std::chrono::nanoseconds cpu_time() {
+            llvm::sys::TimePoint<> elapsed;
+            std::chrono::nanoseconds user, sys;
+            llvm::sys::Process::GetTimeUsage(elapsed, user, sys);
+            return user + sys;
+        }
+
+        // Nested passes run on a single thread from start to end.
+        std::chrono::nanoseconds thread_cpu_time() {
+        #if defined(CLOCK_THREAD_CPUTIME_ID)
+            timespec ts;
+            if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0) {
+                return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+            }
+        #endif
+            return cpu_time();
+        }
+
+        std::size_t count_ops(operation root) {
+            std::size_t ops = 0;
+            root->walk([&] (operation) { ++ops; });
+            return ops;
+        }
+
+        string_ref pass_name(mlir::Pass *pass) {
+            auto arg = pass->getArgument();
+            return arg.empty() ? pass->getName() : arg;
+        }
+
+        bool is_root(operation op) { return !op->getParentOp(); }
+
+        template< typename duration_t >
+        double seconds(duration_t duration) {
+            return std::chrono::duration< double >(duration).count();
+        }
+
+        void add_member(pipeline_statistics::record &rec, string_ref pass) {
+            if (!llvm::is_contained(rec.passes, pass)) {
+                rec.passes.push_back(pass.str());
+            }
+        }
+
+        string_ref to_string(pipeline_statistics::step_kind kind) {
+            switch (kind) {
+                case pipeline_statistics::step_kind::pass:     return "pass";
+                case pipeline_statistics::step_kind::nested:   return "nested";
+                case pipeline_statistics::step_kind::compound: return "compound";
+                case pipeline_statistics::step_kind::phase:    return "phase";
+            }
+            VAST_UNREACHABLE("unknown pipeline step kind");
+        }
+
+    } // namespace
+
+    pipeline_statistics::pipeline_statistics(
+        const pipeline_t &ppl, bool print_table, std::optional< std::string > json_path
+    )
+        : enclosing_steps(ppl.enclosing_steps)
+        , print(print_table)
+        , json_path(std::move(json_path))
+    {}
+
+    pipeline_statistics::~pipeline_statistics() {
+        if (print) {
+            print_table(llvm::errs());
+        }
+
+        if (json_path) {
+            std::error_code ec;
+            llvm::raw_fd_ostream os(*json_path, ec, llvm::sys::fs::OF_Text);
+            if (ec) {
+                llvm::errs() << "error: cannot open pass statistics file '"
+                             << *json_path << "': " << ec.message() << "\n";
+                return;
+            }
+            print_json(os);
+        }
+    }
+
+    auto pipeline_statistics::take_snapshot(operation root) const -> snapshot {
+        return { clock::now(), cpu_time(), count_ops(root), resident_memory() };
+    }
+
+    auto pipeline_statistics::take_nested_snapshot(operation op) const -> snapshot {
+        return { clock::now(), thread_cpu_time(), count_ops(op), resident_memory() };
+    }
+
+    auto pipeline_statistics::get_record(string_ref name, step_kind kind) -> record & {
+        auto [it, inserted] = record_idx.try_emplace(name, records.size());
+        if (inserted) {
+            records.push_back({ .name = name.str(), .kind = kind });
+        }
+        return records[it->second];
+    }
+
+    void pipeline_statistics::runBeforePass(mlir::Pass *pass, operation op) {
+        if (is_root(op)) {
+            if (unit.empty()) {
+                if (auto loc = mlir::dyn_cast< mlir::FileLineColLoc >(op->getLoc())) {
+                    unit = loc.getFilename().str();
+                }
+            }
+            root_start = take_snapshot(op);
+            return;
+        }
+
+        auto start = take_nested_snapshot(op);
+        std::lock_guard< std::mutex > lock(nested_mutex);
+        nested_start[{ pass, op }] = start;
+    }
+
+    void pipeline_statistics::runAfterPass(mlir::Pass *pass, operation op) {
+        if (is_root(op)) {
+            return finish_root_pass(pass, op);
+        }
+        finish_nested_pass(pass, op);
+    }
+
+    void pipeline_statistics::runAfterPassFailed(mlir::Pass *pass, operation op) {
+        runAfterPass(pass, op);
+    }
+
+    void pipeline_statistics::finish_root_pass(mlir::Pass *pass, operation root) {
+        VAST_CHECK(root_start, "missing start of the pass {0}", pass_name(pass));
+        auto start = *root_start;
+        auto end   = take_snapshot(root);
+
+        auto update = [&] (record &rec) {
+            rec.wall += seconds(end.wall - start.wall);
+            rec.cpu  += seconds(end.cpu - start.cpu);
+            if (!rec.ops_before) {
+                rec.ops_before = start.ops;
+            }
+            rec.ops_after  = end.ops;
+            rec.rss_delta += end.rss - start.rss;
+            ++rec.runs;
+        };
+
+        update(get_record(pass_name(pass), step_kind::pass));
+
+        // Pass adaptors are created by the pass manager, hence they are
+        // attributed to the steps of the nested passes they executed.
+        if (auto it = enclosing_steps.find(pass); it != enclosing_steps.end()) {
+            for (const auto &step : it->second) {
+                auto &rec = get_record(step, step_kind::compound);
+                update(rec);
+                add_member(rec, pass_name(pass));
+            }
+        } else {
+            for (const auto &step : nested_steps) {
+                update(get_record(step, step_kind::compound));
+            }
+            for (const auto &[step, nested] : nested_members) {
+                add_member(get_record(step, step_kind::compound), nested);
+            }
+        }
+
+        nested_steps.clear();
+        nested_members.clear();
+        root_start.reset();
+    }
+
+    void pipeline_statistics::finish_nested_pass(mlir::Pass *pass, operation op) {
+        auto end = take_nested_snapshot(op);
+
+        std::lock_guard< std::mutex > lock(nested_mutex);
+        auto it = nested_start.find({ pass, op });
+        VAST_CHECK(it != nested_start.end(), "missing start of the pass {0}", pass_name(pass));
+        auto start = it->second;
+        nested_start.erase(it);
+
+        auto &rec = get_record(pass_name(pass), step_kind::nested);
+        rec.wall += seconds(end.wall - start.wall);
+        rec.cpu  += seconds(end.cpu - start.cpu);
+        rec.ops_before = rec.ops_before.value_or(0) + start.ops;
+        rec.ops_after  = rec.ops_after.value_or(0) + end.ops;
+        rec.rss_delta += end.rss - start.rss;
+        ++rec.runs;
+
+        // Nested passes run as clones on each thread if multithreading is
+        // enabled, the steps are known for the scheduled pass only.
+        auto scheduled = pass->getThreadingSiblingOrThis();
+        if (auto it = enclosing_steps.find(scheduled); it != enclosing_steps.end()) {
+            for (const auto &step : it->second) {
+                if (!llvm::is_contained(nested_steps, step)) {
+                    nested_steps.push_back(step);
+                }
+
+                std::pair< std::string, std::string > member(step, pass_name(pass).str());
+                if (!llvm::is_contained(nested_members, member)) {
+                    nested_members.push_back(std::move(member));
+                }
+            }
+        }
+    }
+
+    void pipeline_statistics::add_counter(string_ref name, std::int64_t value) {
+        counters.emplace_back(name.str(), value);
+    }
+
+    auto pipeline_statistics::start_phase() -> phase_start {
+        return { clock::now(), cpu_time(), resident_memory() };
+    }
+
+    auto pipeline_statistics::finish_phase(
+        string_ref name, const phase_start &start, std::optional< std::size_t > ops
+    ) -> record {
+        return {
+            .name      = name.str(),
+            .kind      = step_kind::phase,
+            .wall      = seconds(clock::now() - start.wall),
+            .cpu       = seconds(cpu_time() - start.cpu),
+            .ops_after = ops,
+            .rss_delta = resident_memory() - start.rss,
+            .runs      = 1
+        };
+    }
+
+    void pipeline_statistics::add_phase(record phase) {
+        auto &rec = get_record(phase.name, step_kind::phase);
+        rec.wall      += phase.wall;
+        rec.cpu       += phase.cpu;
+        rec.ops_after  = phase.ops_after;
+        rec.rss_delta += phase.rss_delta;
+        rec.runs      += phase.runs;
+    }
+
+    void pipeline_statistics::phase_timer::start() {
+        if (depth++ == 0) {
+            wall_start = clock::now();
+            cpu_start  = cpu_time();
+        }
+    }
+
+    void pipeline_statistics::phase_timer::stop() {
+        VAST_CHECK(depth > 0, "phase timer stopped without being started");
+        if (--depth == 0) {
+            wall += seconds(clock::now() - wall_start);
+            cpu  += seconds(cpu_time() - cpu_start);
+        }
+    }
+
+    auto pipeline_statistics::phase_timer::finish(
+        string_ref name, std::optional< std::size_t > ops
+    ) const -> record {
+        return {
+            .name      = name.str(),
+            .kind      = step_kind::phase,
+            .wall      = wall,
+            .cpu       = cpu,
+            .ops_after = ops,
+            .runs      = 1
+        };
+    }
+
+    void pipeline_statistics::print_table(llvm::raw_ostream &os) const {
+        os << "===" << std::string(73, '-') << "===\n"
+           << "                          VAST pipeline statistics\n"
+           << "===" << std::string(73, '-') << "===\n";
+
+        os << llvm::format("  %10s  %10s  %10s  %10s  %12s  %6s  %s\n",
+            "Wall (s)", "CPU (s)", "Ops before", "Ops after", "RSS (KiB)", "Runs", "Name"
+        );
+
+        auto ops = [] (const auto &count) -> std::string {
+            return count ? std::to_string(*count) : "-";
+        };
+
+        for (const auto &rec : records) {
+            auto indent = rec.kind == step_kind::pass || rec.kind == step_kind::phase ? "" : "  ";
+            os << llvm::format("  %10.4f  %10.4f  %10s  %10s  %12lld  %6u  %s%s (%s)\n",
+                rec.wall,
+                rec.cpu,
+                ops(rec.ops_before).c_str(),
+                ops(rec.ops_after).c_str(),
+                static_cast< long long >(rec.rss_delta / 1024),
+                rec.runs,
+                indent,
+                rec.name.c_str(),
+                to_string(rec.kind).data()
+            );
+        }
+
+        for (const auto &[name, value] : counters) {
+            os << llvm::format("  %10lld  %s\n", static_cast< long long >(value), name.c_str());
+        }
+    }
+
+    void pipeline_statistics::print_json(llvm::raw_ostream &os) const {
+        llvm::json::OStream json(os, /* indent */ 2);
+
+        auto optional = [] (const auto &value) -> llvm::json::Value {
+            if (value) {
+                return static_cast< std::int64_t >(*value);
+            }
+            return nullptr;
+        };
+
+        json.object([&] {
+            json.attribute("unit", unit);
+            json.attributeArray("steps", [&] {
+                for (const auto &rec : records) {
+                    json.object([&] {
+                        json.attribute("name", rec.name);
+                        json.attribute("kind", to_string(rec.kind));
+                        json.attribute("wall", rec.wall);
+                        json.attribute("cpu", rec.cpu);
+                        json.attribute("rss_delta", rec.rss_delta);
+                        json.attribute("ops_before", optional(rec.ops_before));
+                        json.attribute("ops_after", optional(rec.ops_after));
+                        json.attribute("runs", static_cast< std::int64_t >(rec.runs));
+                        if (rec.kind == step_kind::compound) {
+                            json.attributeArray("passes", [&] {
+                                for (const auto &name : rec.passes) {
+                                    json.value(name);
+                                }
+                            });
+                        }
+                    });
+                }
+            });
+            json.attributeObject("counters", [&] {
+                for (const auto &[name, value] : counters) {
+                    json.attribute(name, value);
+                }
+            });
+        });
+        os << "\n";
+    }
+
+} // namespace vast
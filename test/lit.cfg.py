@@ -96,3 +96,7 @@ for tool in tools:
         path = [config.vast_tools_dir, tool.command, config.vast_build_type]
         tool.command = os.path.join(*path, tool.command)
     llvm_config.add_tool_substitutions([tool])
+
+# Tests of vast-repl pipe commands to its standard input.
+if os.path.exists(os.path.join(config.vast_tools_dir, 'vast-repl', config.vast_build_type, 'vast-repl')):
+    config.available_features.add('repl')
@@ -0,0 +1,23 @@
+// RUN: %vast-cc1 -vast-emit-mlir-bytecode=hl %s -o %t.mlirbc
+// RUN: %vast-query --show-symbols=functions %t.mlirbc | %file-check %s -check-prefix=FUNCS
+// RUN: %vast-query --symbol-users=a --scope=foo %t.mlirbc | %file-check %s -check-prefix=FOO
+// RUN: %vast-query --symbol-users=a %t.mlirbc | %file-check %s -check-prefix=FOO -check-prefix=MAIN
+// RUN: %vast-opt %t.mlirbc | %file-check %s -check-prefix=OPT
+
+// FUNCS: func : foo
+// FUNCS: func : main
+
+// OPT: hl.func @foo
+// OPT: hl.func @main
+
+// FOO: hl.ref %0
+int foo() {
+    int a;
+    return a;
+}
+
+// MAIN: hl.ref %0
+int main() {
+    int a = 1;
+    return a;
+}
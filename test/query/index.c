@@ -0,0 +1,37 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o %t.mlir
+// RUN: rm -f %t.idx
+// RUN: %vast-query --index=%t.idx --show-symbols=functions %t.mlir | %file-check %s -check-prefix=FUNCS
+// RUN: %file-check %s -check-prefix=INDEX --input-file=%t.idx
+// RUN: %vast-query --index=%t.idx --symbol-users=a --scope=foo %t.mlir | %file-check %s -check-prefix=FOO
+// RUN: %vast-query --index=%t.idx --show-symbols=vars --scope=main %t.mlir | %file-check %s -check-prefix=MAIN-VARS
+
+// RUN: echo '{"show-symbols": "functions"}' > %t.queries
+// RUN: echo '{"symbol-users": "a", "scope": "foo"}' >> %t.queries
+// RUN: %vast-query --index=%t.idx --queries=%t.queries %t.mlir | %file-check %s -check-prefix=BATCH
+// RUN: cat %t.queries | %vast-query --queries=- %t.mlir | %file-check %s -check-prefix=BATCH
+
+// FUNCS: func : foo
+// FUNCS: func : main
+
+// INDEX: "version":1
+
+// MAIN-VARS-NOT: hl.var : x
+// MAIN-VARS: hl.var : b
+// MAIN-VARS-NOT: hl.var : x
+
+// BATCH: "query":0
+// BATCH-SAME: func : foo
+// BATCH-SAME: func : main
+// BATCH: "query":1
+// BATCH-SAME: hl.ref %0
+
+// FOO: hl.ref %0
+int foo() {
+    int a, x;
+    return a;
+}
+
+int main() {
+    int b = 1;
+    return b;
+}
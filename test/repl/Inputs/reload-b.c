@@ -0,0 +1,3 @@
+int unchanged(int x) { return __builtin_abs(x) + 1; }
+
+int edited(int x) { return x * 2; }
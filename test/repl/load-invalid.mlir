@@ -0,0 +1,9 @@
+// RUN: printf "load %s\n show module\n show symbols\n exit" | %vast-repl 2>&1 | %file-check %s
+// REQUIRES: repl
+
+// Commands report the broken module instead of building a tower of it.
+
+// CHECK: error: cannot parse module
+// CHECK: error: cannot parse module
+
+this is not a module
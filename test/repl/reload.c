@@ -0,0 +1,24 @@
+// RUN: cp %S/Inputs/reload-a.c %t.c
+// RUN: rm -f %t.out
+// RUN: ( printf "load %t.c\n show module\n"; \
+// RUN:   for i in $(seq 100); do grep -q "hl.func @edited" %t.out && break; sleep 0.1; done; \
+// RUN:   cp %S/Inputs/reload-b.c %t.c; \
+// RUN:   printf "load %t.c\n show module\n exit\n" ) | %vast-repl > %t.out
+// RUN: %file-check %s --input-file=%t.out
+// REQUIRES: repl, shell
+
+// The file is edited between the two loads. The body of @unchanged may be
+// reused, but the declaration of the builtin it calls has to be emitted
+// again.
+
+// CHECK-LABEL: module{{.*}} attributes {
+// CHECK-DAG:   hl.func @__builtin_abs
+// CHECK-DAG:   hl.call @__builtin_abs
+// CHECK-DAG:   hl.sub
+// CHECK-NOT:   hl.mul
+
+// CHECK-LABEL: module{{.*}} attributes {
+// CHECK-DAG:   hl.func @__builtin_abs
+// CHECK-DAG:   hl.call @__builtin_abs
+// CHECK-DAG:   hl.mul
+// CHECK-NOT:   hl.sub
@@ -0,0 +1,23 @@
+// RUN: printf "load %s\n raise vast-hl-dce\n raise vast-hl-to-ll-cf\n show tower\n exit" | %vast-repl | %file-check %s
+// REQUIRES: repl
+
+// Dead code elimination leaves @live untouched, hence its body is kept only
+// by level 1 once level 2 freezes it. Links of level 1 are resolved from the
+// shared body. The top level shares nothing with its parent.
+
+// CHECK:      level 0
+// CHECK-NEXT:   @live shared
+// CHECK-NEXT:   @dead{{$}}
+// CHECK-NEXT: level 1 from 0
+// CHECK-NEXT:   @live links: all
+// CHECK-NEXT:   @dead links: all
+// CHECK-NEXT: level 2 from 1
+// CHECK-NEXT:   @live links: {{all|some}}
+// CHECK-NEXT:   @dead links: {{all|some}}
+
+int live(int x) { return x + 1; }
+
+int dead(int x) {
+    return x;
+    x = x + 1;
+}
@@ -0,0 +1,25 @@
+// RUN: %vast-front -vast-emit-mlir=hl %s -o - | %vast-opt --vast-hl-lower-types --vast-emit-abi | %file-check %s -check-prefix=ABI
+
+// `a` alone does not fill the first eightbyte, the following fields share it
+// and the whole eightbyte is passed as a single integer.
+
+struct fields
+{
+    int a;
+    short b;
+    short c;
+    long d;
+};
+
+long fn( struct fields f )
+{
+    return f.a + f.c + f.d;
+}
+
+int main()
+{
+    // ABI:      abi.call_exec @fn({{.*}}) {
+    // ABI:        abi.call @fn({{.*}}) : (i64, i64) -> si64
+    struct fields f;
+    return fn( f );
+}
@@ -0,0 +1,73 @@
+// RUN: %vast-front -vast-emit-mlir=hl %s -o - | %vast-opt --vast-hl-lower-types | %file-check %s -check-prefix=HL
+// RUN: %vast-front -vast-emit-mlir=hl %s -o - | %vast-opt --vast-hl-lower-types --vast-emit-abi | %file-check %s -check-prefix=ABI
+
+struct vec
+{
+    int a;
+    int b;
+};
+
+// `first` and `second` share a function type and therefore its classification.
+
+// HL:      hl.func @first{{.*}}(%arg0: !hl.lvalue<!hl.elaborated<!hl.record<"vec">>>) -> si32
+// HL:        hl.call @second({{.*}}) : (!hl.elaborated<!hl.record<"vec">>) -> si32
+// HL:        hl.return {{.*}} : si32
+
+// ABI-LABEL: abi.func {{.*}}@vast.abi.second{{.*}}(%arg0: !hl.lvalue<i64>) -> si32
+// ABI-NEXT:    [[P0:%[0-9]+]] = abi.prologue {
+// ABI-NEXT:      [[P1:%[0-9]+]] = abi.direct %arg0 : !hl.lvalue<i64> -> !hl.lvalue<!hl.elaborated<!hl.record<"vec">>>
+// ABI-NEXT:      {{.*}} = abi.yield [[P1]] : !hl.lvalue<!hl.elaborated<!hl.record<"vec">>> -> si32
+// ABI-NEXT:    } : !hl.lvalue<!hl.elaborated<!hl.record<"vec">>>
+// ABI:         [[E0:%[0-9]+]] = abi.epilogue {
+// ABI-NEXT:      [[E1:%[0-9]+]] = abi.direct {{.*}} : si32 -> si32
+// ABI-NEXT:      {{.*}} = abi.yield [[E1]] : si32 -> si32
+// ABI-NEXT:    } : si32
+// ABI-NEXT:    hl.return [[E0]] : si32
+// ABI-NEXT:  }
+// ABI-NOT:   hl.func @second
+int second( struct vec v )
+{
+    return v.a * v.b;
+}
+
+// ABI-LABEL: abi.func {{.*}}@vast.abi.first{{.*}}(%arg0: !hl.lvalue<i64>) -> si32
+// ABI-NEXT:    [[P0:%[0-9]+]] = abi.prologue {
+// ABI-NEXT:      [[P1:%[0-9]+]] = abi.direct %arg0 : !hl.lvalue<i64> -> !hl.lvalue<!hl.elaborated<!hl.record<"vec">>>
+// ABI-NEXT:      {{.*}} = abi.yield [[P1]] : !hl.lvalue<!hl.elaborated<!hl.record<"vec">>> -> si32
+// ABI-NEXT:    } : !hl.lvalue<!hl.elaborated<!hl.record<"vec">>>
+// ABI:         [[C0:%[0-9]+]] = abi.call_exec @second({{.*}}) {
+// ABI-NEXT:      [[C1:%[0-9]+]] = abi.call_args {
+// ABI-NEXT:        [[C2:%[0-9]+]] = abi.direct {{.*}} : !hl.elaborated<!hl.record<"vec">> -> i64
+// ABI-NEXT:        {{.*}} = abi.yield [[C2]] : i64 -> i64
+// ABI-NEXT:      } : i64
+// ABI-NEXT:      [[C3:%[0-9]+]] = abi.call @second([[C1]]) : (i64) -> si32
+// ABI-NEXT:      [[C4:%[0-9]+]] = abi.call_rets {
+// ABI-NEXT:        [[C5:%[0-9]+]] = abi.direct [[C3]] : si32 -> si32
+// ABI-NEXT:        {{.*}} = abi.yield [[C5]] : si32 -> si32
+// ABI-NEXT:      } : si32
+// ABI-NEXT:      {{.*}} = abi.yield [[C4]] : si32 -> si32
+// ABI-NEXT:    } : (!hl.elaborated<!hl.record<"vec">>) -> si32
+// ABI:         [[E0:%[0-9]+]] = abi.epilogue {
+// ABI-NEXT:      [[E1:%[0-9]+]] = abi.direct {{.*}} : si32 -> si32
+// ABI-NEXT:      {{.*}} = abi.yield [[E1]] : si32 -> si32
+// ABI-NEXT:    } : si32
+// ABI-NEXT:    hl.return [[E0]] : si32
+// ABI-NEXT:  }
+// ABI-NOT:   hl.func @first
+int first( struct vec v )
+{
+    return second( v ) + 1;
+}
+
+// `main` keeps its signature and returns its value directly.
+
+// ABI-LABEL: hl.func @main
+// ABI:         abi.call_exec @first
+// ABI:         abi.call @first({{.*}}) : (i64) -> si32
+// ABI-NOT:     abi.epilogue
+// ABI:         hl.return {{.*}} : si32
+int main()
+{
+    struct vec v = { 2, 3 };
+    return first( v );
+}
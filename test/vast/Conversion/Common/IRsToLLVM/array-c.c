@@ -0,0 +1,21 @@
+// RUN: %vast-front -vast-emit-mlir=llvm -o - %s | %file-check %s
+// RUN: %vast-front -vast-emit-llvm -o - %s | %file-check %s -check-prefix=LLVM
+
+// CHECK: llvm.mlir.global internal constant @table() {{.*}} : !llvm.array<16 x i32> {
+// CHECK:   [[V1:%[0-9]+]] = llvm.mlir.constant(dense<[0, 1, 4, 9, 16, 25, 36, 49, 64, 81, 100, 121, 144, 169, 196, 225]> : tensor<16xi32>) : !llvm.array<16 x i32>
+// CHECK:   llvm.return [[V1]] : !llvm.array<16 x i32>
+// CHECK: }
+// LLVM: @table = internal constant [16 x i32] [i32 0, i32 1, i32 4, i32 9, i32 16, i32 25, i32 36, i32 49, i32 64, i32 81, i32 100, i32 121, i32 144, i32 169, i32 196, i32 225]
+const unsigned table[16] = {
+    0, 1, 4, 9, 16, 25, 36, 49, 64, 81, 100, 121, 144, 169, 196, 225
+};
+
+unsigned square(unsigned i) { return table[i]; }
+
+void local() {
+    // CHECK: llvm.mlir.constant(dense<1.000000e+00> : tensor<16xf32>) : !llvm.array<16 x f32>
+    float ones[16] = {
+        1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
+        1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f
+    };
+}
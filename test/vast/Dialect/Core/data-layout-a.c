@@ -0,0 +1,8 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o - | %file-check %s
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o - | %vast-opt | %file-check %s
+
+// CHECK: vast.core.data_layout = #core.dl_table<#dlti.dl_spec<
+// CHECK-DAG: #dlti.dl_entry<!hl.int, {vast.abi_align.key = 32 : i32, vast.dl.bw = 32 : i32}>
+// CHECK-DAG: #dlti.dl_entry<!hl.char, {vast.abi_align.key = 8 : i32, vast.dl.bw = 8 : i32}>
+int i;
+char c;
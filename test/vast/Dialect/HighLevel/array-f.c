@@ -0,0 +1,29 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o - | %file-check %s
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o %t && %vast-opt %t | diff -B %t -
+
+// CHECK: hl.var "table" : !hl.lvalue<!hl.array<16, !hl.int< unsigned, const >>> = {
+// CHECK:   [[V1:%[0-9]+]] = hl.const #core.dense<dense<[0, 1, 4, 9, 16, 25, 36, 49, 64, 81, 100, 121, 144, 169, 196, 225]> : tensor<16xi32>> : !hl.array<16, !hl.int< unsigned, const >>
+// CHECK:   hl.value.yield [[V1]]
+const unsigned table[16] = {
+    0, 1, 4, 9, 16, 25, 36, 49, 64, 81, 100, 121, 144, 169, 196, 225
+};
+
+// CHECK: hl.var "filled" : !hl.lvalue<!hl.array<32, !hl.double>> = {
+// CHECK:   hl.const #core.dense<dense<{{.*}}> : tensor<32xf64>> : !hl.array<32, !hl.double>
+double filled[32] = { 0.5, 1.5 };
+
+// CHECK: hl.var "zeros" : !hl.lvalue<!hl.array<64, !hl.char>> = {
+// CHECK:   hl.const #core.dense<dense<0> : tensor<64xi8>> : !hl.array<64, !hl.char>
+char zeros[64] = { 0 };
+
+// Small arrays keep an operation per element.
+// CHECK: hl.var "small" : !hl.lvalue<!hl.array<3, !hl.int>> = {
+// CHECK:   hl.initlist
+int small[3] = { 1, 2, 3 };
+
+void locals(int x) {
+    // Initializers that are not constant keep an operation per element.
+    // CHECK: hl.var "dynamic" : !hl.lvalue<!hl.array<16, !hl.int>> = {
+    // CHECK:   hl.initlist
+    int dynamic[16] = { x, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+}
@@ -0,0 +1,26 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o %t
+// RUN: %file-check %s --input-file=%t
+// RUN: %file-check %s --input-file=%t --check-prefix=TWICE
+// RUN: %vast-opt %t | diff -B %t -
+
+// Uses before and after the definition refer to the same function.
+
+// TWICE: hl.func @twice
+// TWICE-NOT: hl.func @twice
+
+int twice(int);
+
+// CHECK: hl.func @use
+int use(int x) {
+    // CHECK: hl.call @twice
+    return twice(x);
+}
+
+int twice(int);
+int twice(int x) { return x * 2; }
+
+// CHECK: hl.func @bump
+int bump(int x) {
+    // CHECK: hl.call @twice
+    return twice(x + 1);
+}
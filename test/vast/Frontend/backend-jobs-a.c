@@ -0,0 +1,33 @@
+// RUN: %vast-front -vast-emit-llvm -vast-backend-jobs=2 %s -o %t.ll
+// RUN: cat %t.ll %t.1.ll | %file-check %s
+// RUN: cat %t.ll %t.1.ll | grep -c "^define" | %file-check %s -check-prefix=DEFS
+
+// Functions are split between the two partitions, the static helper is
+// called from both of them, hence it is copied to both.
+
+// CHECK-DAG: define {{.*}}@foo(
+// CHECK-DAG: define {{.*}}@bar(
+// CHECK-DAG: define internal {{.*}}@helper(
+// CHECK-DAG: define internal {{.*}}@helper(
+// CHECK-NOT: helper.vast
+
+// DEFS: 4
+
+static int helper(int x) { return x + 1; }
+
+int foo(int a, int b) {
+    int r = helper(a);
+    for (int i = 0; i < b; ++i) {
+        r = r * 3 + helper(i);
+    }
+    return r;
+}
+
+int bar(int a, int b) {
+    int r = helper(b);
+    while (a > 0) {
+        r = r - helper(a);
+        a = a / 2;
+    }
+    return r;
+}
@@ -0,0 +1,25 @@
+// RUN: %vast-front -vast-emit-llvm -vast-backend-jobs=2 %s -o %t.ll
+// RUN: cat %t.ll %t.1.ll | %file-check %s
+
+// The static counter is used from both partitions, hence it is defined by
+// one of them as a hidden symbol and declared by the other.
+
+// CHECK-DAG: @counter.vast.{{[0-9a-f]+}} = hidden global
+// CHECK-DAG: @counter.vast.{{[0-9a-f]+}} = external hidden global
+
+static int counter;
+
+int foo(int a) {
+    for (int i = 0; i < a; ++i) {
+        counter += i;
+    }
+    return counter;
+}
+
+int bar(int b) {
+    while (b > 0) {
+        counter -= b;
+        b = b / 2;
+    }
+    return counter;
+}
@@ -0,0 +1,17 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: echo '[{"directory": "%t", "command": "clang -c %s -o a.mlir", "file": "%s"},' > %t/compile_commands.json
+// RUN: echo ' {"directory": "%t", "command": "clang -c %s -DSECOND -o b.mlir", "file": "%s"}]' >> %t/compile_commands.json
+// RUN: %vast-front -vast-batch=%t/compile_commands.json -j 2 -vast-emit-mlir=hl 2>&1 | %file-check %s -check-prefix=BATCH
+// RUN: %file-check %s -check-prefix=FIRST --input-file=%t/a.mlir
+// RUN: %file-check %s -check-prefix=SECOND --input-file=%t/b.mlir
+
+// BATCH: compiled 2 of 2 translation units
+
+// FIRST: hl.func @first
+// SECOND: hl.func @second
+
+#ifdef SECOND
+int second(int x) { return x; }
+#else
+int first(int x) { return x; }
+#endif
@@ -0,0 +1,27 @@
+// RUN: rm -rf %t.cache
+// RUN: %vast-front -vast-emit-mlir=llvm %s -o %t.mlir
+// RUN: %vast-front -vast-emit-mlir=llvm -vast-compilation-cache=%t.cache -vast-pass-statistics=%t.miss.json %s -o %t.miss.mlir
+// RUN: %vast-front -vast-emit-mlir=llvm -vast-compilation-cache=%t.cache -vast-pass-statistics=%t.hit.json %s -o %t.hit.mlir
+// RUN: diff %t.mlir %t.miss.mlir
+// RUN: diff %t.mlir %t.hit.mlir
+// RUN: %file-check %s --check-prefix=MISS --input-file=%t.miss.json
+// RUN: %file-check %s --check-prefix=HIT --input-file=%t.hit.json
+
+// MISS-DAG: "compilation-cache.hits": 0
+// MISS-DAG: "compilation-cache.misses": 3
+
+// HIT-DAG: "compilation-cache.hits": 3
+// HIT-DAG: "compilation-cache.misses": 0
+
+struct point { int x, y; };
+
+static int sum(struct point p) { return p.x + p.y; }
+
+int scale(struct point p, int k) {
+    return sum(p) * k;
+}
+
+int main(void) {
+    struct point p = { 1, 2 };
+    return scale(p, 3);
+}
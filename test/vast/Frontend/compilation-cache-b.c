@@ -0,0 +1,20 @@
+// RUN: rm -rf %t.cache
+// RUN: %vast-front -vast-emit-mlir=llvm -vast-compilation-cache=%t.cache %s -o %t.miss.mlir
+// RUN: %vast-front -vast-emit-mlir=llvm -vast-compilation-cache=%t.cache -DCHANGED %s -o - | %file-check %s
+
+// Cached string literals get fresh names if the name is already taken.
+
+// CHECK-DAG: llvm.mlir.global internal constant @[[FIRST:vast.strlit.constant_[0-9_]+]]("first\00")
+// CHECK-DAG: llvm.mlir.global internal constant @[[SECOND:vast.strlit.constant_[0-9_]+]]("second\00")
+// CHECK-LABEL: llvm.func @first
+// CHECK: llvm.mlir.addressof @[[FIRST]]
+// CHECK-LABEL: llvm.func @second
+// CHECK: llvm.mlir.addressof @[[SECOND]]
+
+const char *first(void) { return "first"; }
+
+#ifdef CHANGED
+const char *second(void) { return "second"; }
+#else
+const char *second(void) { return 0; }
+#endif
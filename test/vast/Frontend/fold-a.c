@@ -0,0 +1,30 @@
+// RUN: %vast-front -vast-emit-mlir=hl -vast-simplify %s -o - | %file-check %s
+// RUN: %vast-front -vast-emit-mlir=hl -vast-simplify -vast-disable-fold %s -o - | %file-check %s --check-prefix=NOFOLD
+
+// CHECK: hl.var "a"
+// CHECK-NEXT: hl.const #core.integer<7> : !hl.int
+// CHECK-NOT: hl.add
+// NOFOLD: hl.var "a"
+// NOFOLD: hl.mul
+// NOFOLD: hl.add
+int a = 1 + 2 * 3;
+
+// CHECK: hl.var "b"
+// CHECK-NEXT: hl.const #core.integer<0> : !hl.int
+// CHECK-NOT: hl.cmp
+int b = 5 < -1;
+
+// CHECK: hl.var "c"
+// CHECK-NEXT: hl.const #core.float<2.500000e+00> : !hl.double
+// CHECK-NOT: hl.fmul
+double c = 0.5 * 5;
+
+// Division by zero is kept as it is.
+// CHECK-LABEL: hl.func @div
+// CHECK: hl.sdiv
+int div(void) { return 1 / 0; }
+
+// CHECK-LABEL: hl.func @same
+// CHECK-NOT: hl.add
+// CHECK: hl.return
+int same(int x) { return x + 0; }
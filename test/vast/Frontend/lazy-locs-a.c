@@ -0,0 +1,14 @@
+// RUN: %vast-front -vast-emit-mlir=hl -vast-show-locs %s -o %t.mlir
+// RUN: %vast-front -vast-emit-mlir=hl -vast-show-locs -vast-lazy-locs %s -o %t.lazy.mlir
+// RUN: diff %t.mlir %t.lazy.mlir
+// RUN: %vast-front -vast-emit-mlir=llvm -vast-show-locs %s -o %t.llvm.mlir
+// RUN: %vast-front -vast-emit-mlir=llvm -vast-show-locs -vast-lazy-locs %s -o %t.llvm.lazy.mlir
+// RUN: diff %t.llvm.mlir %t.llvm.lazy.mlir
+
+#define ADD(a, b) ((a) + (b))
+
+int add(int x, int y) {
+    return ADD(x, y);
+}
+
+int main(void) { return add(1, 2); }
@@ -0,0 +1,19 @@
+// RUN: %vast-front -vast-emit-mlir=hl -vast-show-locs %s -o - | %file-check %s
+// RUN: %vast-front -vast-emit-mlir=hl -vast-show-locs -vast-lazy-locs %s -o - | %file-check %s
+
+// Locations are looked up as by `clang::FullSourceLoc`, i.e., in the file id
+// of the location itself. Expressions expanded from a macro are not in a file.
+
+#define ADD(a, b) ((a) + (b))
+
+int add(int x, int y) {
+    // CHECK: hl.add {{.*}} unknown:1:1
+    // CHECK: hl.return {{.*}} {{.*}}macro-locs-a.c:[[# @LINE + 1]]:5
+    return ADD(x, y);
+}
+
+int sub(int x, int y) {
+    // CHECK: hl.sub {{.*}} {{.*}}macro-locs-a.c:[[# @LINE + 2]]:14
+    // CHECK: hl.return {{.*}} {{.*}}macro-locs-a.c:[[# @LINE + 1]]:5
+    return x - y;
+}
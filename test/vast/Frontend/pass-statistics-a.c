@@ -0,0 +1,18 @@
+// RUN: %vast-front -vast-emit-mlir=llvm -vast-pass-statistics=%t.json %s -o %t.mlir
+// RUN: %file-check %s --input-file=%t.json
+
+// CHECK: "steps": [
+// CHECK-DAG: "name": "vast-hl-to-ll-vars",
+// CHECK-DAG: "kind": "nested",
+// CHECK-DAG: "name": "to-ll",
+// CHECK-DAG: "kind": "compound",
+// CHECK-DAG: "ops_before":
+// CHECK-DAG: "rss_delta":
+
+int inc(int x) {
+    if (x > 0)
+        return x + 1;
+    return x;
+}
+
+int main(void) { return inc(1); }
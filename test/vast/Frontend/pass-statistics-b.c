@@ -0,0 +1,14 @@
+// RUN: %vast-front -vast-emit-mlir=hl -vast-simplify -vast-pass-statistics=%t.json %s -o %t.mlir
+// RUN: %file-check %s --input-file=%t.json
+
+// CHECK: "counters": {
+// CHECK-DAG: "codegen.type-cache.hits": {{[1-9][0-9]*}}
+// CHECK-DAG: "codegen.type-cache.misses": {{[1-9][0-9]*}}
+// CHECK-DAG: "codegen.mangle-cache.hits": {{[1-9][0-9]*}}
+
+typedef unsigned long size;
+
+size add(size a, size b) { return a + b; }
+size sub(size a, size b) { return a - b; }
+
+size twice(size a) { return add(a, a) + sub(add(a, a), a); }
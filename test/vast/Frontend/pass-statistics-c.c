@@ -0,0 +1,24 @@
+// RUN: %vast-front -vast-emit-llvm -vast-pass-statistics=%t.json %s -o %t.ll
+// RUN: %file-check %s --input-file=%t.json
+// RUN: %file-check %s --input-file=%t.json -check-prefix=CODEGEN
+
+// CHECK: "steps": [
+// CHECK-DAG: "name": "codegen",
+// CHECK-DAG: "kind": "phase",
+// CHECK-DAG: "name": "to-llvm",
+// CHECK-DAG: "name": "llvm-translation",
+// CHECK-DAG: "name": "llvm-backend",
+
+// Code generation excludes parsing, its memory is not measured.
+// CODEGEN:      "name": "codegen",
+// CODEGEN-NEXT: "kind": "phase",
+// CODEGEN-NEXT: "wall": {{.*}},
+// CODEGEN-NEXT: "cpu": {{.*}},
+// CODEGEN-NEXT: "rss_delta": 0,
+// CODEGEN-NEXT: "ops_before": null,
+// CODEGEN-NEXT: "ops_after": {{[1-9][0-9]*}},
+// CODEGEN-NEXT: "runs": 1
+
+int square(int x) { return x * x; }
+
+int main(void) { return square(3); }
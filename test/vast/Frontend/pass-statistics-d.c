@@ -0,0 +1,19 @@
+// RUN: %vast-front -vast-emit-mlir=hl -vast-simplify -vast-pass-statistics=%t.json %s -o %t.mlir
+// RUN: %file-check %s --input-file=%t.json
+// RUN: %vast-front -vast-emit-mlir=hl -vast-simplify -vast-disable-multithreading -vast-pass-statistics=%t.st.json %s -o %t.st.mlir
+// RUN: %file-check %s --input-file=%t.st.json
+
+// Time of the adaptor running nested passes is included in their step.
+
+// CHECK: "name": "simplify",
+// CHECK-NEXT: "kind": "compound",
+// CHECK: "passes": [
+// CHECK-NOT: ]
+// CHECK: "vast-hl-dce"
+
+int dead(int x) {
+    return x;
+    x = x + 1;
+}
+
+int main(void) { return dead(1); }
@@ -0,0 +1,41 @@
+// RUN: %vast-front -vast-emit-mlir=llvm -vast-pass-statistics=%t.json %s -o %t.mlir
+// RUN: %file-check %s --input-file=%t.json --check-prefix=VARS
+// RUN: %file-check %s --input-file=%t.json --check-prefix=CF
+
+// Function-local conversions are nested on functions, i.e., they run once
+// per each of the three functions. Their operations are counted in the
+// functions only.
+
+// VARS: "name": "vast-hl-to-ll-vars",
+// VARS-NEXT: "kind": "nested",
+// VARS-NEXT: "wall":
+// VARS-NEXT: "cpu":
+// VARS-NEXT: "rss_delta":
+// VARS-NEXT: "ops_before": {{[1-9][0-9]*}},
+// VARS-NEXT: "ops_after": {{[1-9][0-9]*}},
+// VARS-NEXT: "runs": 3
+
+// CF: "name": "vast-hl-to-ll-cf",
+// CF-NEXT: "kind": "nested",
+// CF-NEXT: "wall":
+// CF-NEXT: "cpu":
+// CF-NEXT: "rss_delta":
+// CF-NEXT: "ops_before": {{[1-9][0-9]*}},
+// CF-NEXT: "ops_after": {{[1-9][0-9]*}},
+// CF-NEXT: "runs": 3
+
+int magnitude(int x) {
+    int y = x;
+    if (y < 0)
+        y = -y;
+    return y;
+}
+
+int sum(int n) {
+    int s = 0;
+    for (int i = 0; i < n; ++i)
+        s += magnitude(i);
+    return s;
+}
+
+int main(void) { return sum(3); }
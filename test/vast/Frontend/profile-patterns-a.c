@@ -0,0 +1,24 @@
+// RUN: %vast-front -vast-emit-mlir=llvm -vast-profile-patterns=%t.json %s -o %t.mlir
+// RUN: %file-check %s --input-file=%t.json
+// RUN: %vast-front -vast-emit-mlir=llvm -vast-profile-patterns %s -o %t.table.mlir 2>&1 | %file-check %s --check-prefix=TABLE
+// RUN: %vast-front -vast-emit-mlir=llvm %s -o %t.plain.mlir
+// RUN: diff %t.mlir %t.plain.mlir
+
+// CHECK: "patterns": [
+// CHECK-DAG: "name": "hl.add"
+// CHECK-DAG: "name": "hl.func"
+// CHECK-DAG: "attempts":
+// CHECK-DAG: "successes":
+// CHECK-DAG: "failures":
+// CHECK-DAG: "time_ms":
+
+// TABLE: VAST pattern profile
+// TABLE: Attempts
+
+int inc(int x) {
+    if (x > 0)
+        return x + 1;
+    return x;
+}
+
+int main(void) { return inc(1); }
@@ -0,0 +1,17 @@
+// RUN: %vast-front -vast-emit-mlir=hl %s -o - | %vast-opt --vast-hl-lower-elaborated-types --vast-hl-lower-typedefs | %file-check %s
+
+typedef int T;
+
+// CHECK: hl.var "a" : !hl.lvalue<!hl.int>
+T a = 0;
+
+void f(void) {
+    typedef short T;
+    // CHECK: hl.var "b" : !hl.lvalue<!hl.short>
+    T b = 0;
+}
+
+void g(void) {
+    // CHECK: hl.var "c" : !hl.lvalue<!hl.int>
+    T c = 0;
+}
@@ -0,0 +1,12 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o - | %vast-opt --vast-hl-dce --vast-hl-lower-types --vast-hl-lower-elaborated-types --vast-hl-lower-typedefs | %file-check %s
+
+typedef struct X { int a; } X;
+typedef X XX;
+typedef XX *XXP;
+typedef XXP XXPP;
+
+// CHECK: {{.*}} = hl.var "x" : !hl.lvalue<!hl.record<"X">>
+XX x;
+
+// CHECK: {{.*}} = hl.var "p" : !hl.lvalue<!hl.ptr<!hl.record<"X">>>
+XXPP p;
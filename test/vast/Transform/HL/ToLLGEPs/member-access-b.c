@@ -0,0 +1,14 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o - | %vast-opt --vast-hl-lower-types --vast-hl-to-ll-geps | %file-check %s
+
+struct X { int a; int b; };
+struct Y { struct X x; int c; };
+
+void fn()
+{
+    struct Y y;
+    // CHECK: "ll.gep"({{.*}}) {idx = 1 : i32, name = "c"}
+    y.c = 1;
+    // CHECK: "ll.gep"({{.*}}) {idx = 0 : i32, name = "x"}
+    // CHECK: "ll.gep"({{.*}}) {idx = 1 : i32, name = "b"}
+    y.x.b = 2;
+}
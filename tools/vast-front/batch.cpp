@@ -0,0 +1,219 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+//===----------------------------------------------------------------------===//
+//
+// Batch mode of vast-front, that compiles all translation units listed in
+// a compilation database within a single process:
+//
+//   vast-front -vast-batch=compile_commands.json -j 8 -vast-emit-mlir=hl
+//
+//===----------------------------------------------------------------------===//
+
+#include "vast/Util/Warnings.hpp"
+
+VAST_RELAX_WARNINGS
+#include <clang/Tooling/JSONCompilationDatabase.h>
+#include <llvm/Support/FormatVariadic.h>
+#include <llvm/Support/ThreadPool.h>
+#include <llvm/Support/Threading.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Frontend/Driver.hpp"
+#include "vast/Frontend/Options.hpp"
+#include "vast/Frontend/SharedContext.hpp"
+
+#include <atomic>
+#include <chrono>
+
+namespace vast::cc {
+
+    extern int cc1(const vast_args &vargs, argv_t argv, arg_t tool, void *main_addr, bool batch);
+
+    namespace {
+
+        struct batch_options
+        {
+            std::string compilation_database;
+            // Zero requests all available hardware threads.
+            unsigned jobs = 0;
+            // Arguments appended to every compile command of the database.
+            std::vector< std::string > extra_args;
+        };
+
+        std::string batch_option_prefix() {
+            return (vast_option_prefix + opt::batch + "=").str();
+        }
+
+        std::optional< batch_options > parse_batch_options(const argv_storage_base &cmd_args) {
+            batch_options opts;
+            auto prefix = batch_option_prefix();
+
+            auto parse_jobs = [&] (string_ref value) {
+                if (value.getAsInteger(10, opts.jobs) || opts.jobs == 0) {
+                    llvm::errs() << "error: invalid number of jobs '" << value << "'\n";
+                    return false;
+                }
+                return true;
+            };
+
+            for (std::size_t i = 1; i < cmd_args.size(); ++i) {
+                // Skip end-of-line response file markers
+                if (cmd_args[i] == nullptr)
+                    continue;
+
+                auto arg = string_ref(cmd_args[i]);
+                if (arg.consume_front(prefix)) {
+                    opts.compilation_database = arg.str();
+                } else if (arg == "-j") {
+                    if (++i == cmd_args.size() || !parse_jobs(cmd_args[i])) {
+                        return std::nullopt;
+                    }
+                } else if (arg.consume_front("-j")) {
+                    if (!parse_jobs(arg)) {
+                        return std::nullopt;
+                    }
+                } else {
+                    // annotate vast arguments as plugin arguments to be passed to the frontend
+                    bool annotated = !opts.extra_args.empty() && opts.extra_args.back() == "-Xclang";
+                    if (arg.startswith(vast_option_prefix) && !annotated) {
+                        opts.extra_args.emplace_back("-Xclang");
+                    }
+                    opts.extra_args.push_back(arg.str());
+                }
+            }
+
+            if (opts.compilation_database.empty()) {
+                llvm::errs() << "error: expected path to compilation database\n";
+                return std::nullopt;
+            }
+
+            return opts;
+        }
+
+        int compile(
+            const clang::tooling::CompileCommand &cmd, const batch_options &opts,
+            const std::string &tool, void *main_addr
+        ) {
+            // The working directory is shared by all workers, hence paths are
+            // resolved relative to the directory of the command instead.
+            std::vector< std::string > storage = { cmd.CommandLine.front() };
+            storage.emplace_back("-working-directory");
+            storage.push_back(cmd.Directory);
+            storage.insert(storage.end(), std::next(cmd.CommandLine.begin()), cmd.CommandLine.end());
+            storage.insert(storage.end(), opts.extra_args.begin(), opts.extra_args.end());
+
+            argv_storage args;
+            for (const auto &arg : storage) {
+                args.push_back(arg.c_str());
+            }
+
+            // The driver mode is derived from the compiler of the command,
+            // e.g., c++ commands are compiled as C++.
+            std::set< std::string > saved_string;
+            auto target_and_mode = toolchain::getTargetAndModeFromProgramName(storage.front());
+            insert_target_and_mode_args(target_and_mode, args, saved_string);
+
+            errs_diagnostics diags(args, tool);
+            clang_driver drv(tool, llvm::sys::getDefaultTargetTriple(), diags.engine, "vast compiler");
+            drv.ResourceDir = CLANG_RESOURCE_DIR;
+            drv.setTargetAndMode(target_and_mode);
+
+            std::unique_ptr< clang_compilation > comp(drv.BuildCompilation(args));
+            if (!comp || comp->containsError()) {
+                diags.finish();
+                return 1;
+            }
+
+            int result = 0;
+            for (const auto &job : comp->getJobs()) {
+                const auto &job_args = job.getArguments();
+                if (job_args.empty() || string_ref(job_args.front()) != "-cc1") {
+                    llvm::errs() << "warning: skipping '" << job.getExecutable()
+                                 << "' job of '" << cmd.Filename << "' in the batch mode\n";
+                    continue;
+                }
+
+                argv_storage cc1_args = { tool.c_str() };
+                cc1_args.append(job_args.begin(), job_args.end());
+
+                auto [vargs, ccargs] = filter_args(cc1_args);
+                auto ccargs_ref = llvm::ArrayRef(ccargs).slice(2);
+                result |= cc1(vargs, ccargs_ref, tool.c_str(), main_addr, /* batch */ true);
+            }
+
+            diags.finish();
+            return result;
+        }
+
+    } // namespace
+
+    bool is_batch_mode(const argv_storage_base &cmd_args) {
+        auto prefix = batch_option_prefix();
+        return llvm::any_of(cmd_args, [&] (auto arg) {
+            return arg && string_ref(arg).startswith(prefix);
+        });
+    }
+
+    int batch(const argv_storage_base &cmd_args, void *main_addr) {
+        auto opts = parse_batch_options(cmd_args);
+        if (!opts) {
+            return 1;
+        }
+
+        std::string error;
+        auto db = clang::tooling::JSONCompilationDatabase::loadFromFile(
+            opts->compilation_database, error, clang::tooling::JSONCommandLineSyntax::AutoDetect
+        );
+
+        if (!db) {
+            llvm::errs() << "error: " << error << "\n";
+            return 1;
+        }
+
+        auto commands = db->getAllCompileCommands();
+        auto tool     = llvm::sys::fs::getMainExecutable(cmd_args[0], main_addr);
+
+        // Translation units create their contexts from a single dialect
+        // registry and share the thread pool of the pass manager.
+        shared_context_state shared(llvm::hardware_concurrency());
+        set_shared_context_state(&shared);
+
+        using clock = std::chrono::steady_clock;
+        auto start = clock::now();
+
+        std::atomic< unsigned > failed = 0;
+        unsigned jobs = 0;
+        {
+            llvm::ThreadPool workers(llvm::hardware_concurrency(opts->jobs));
+            jobs = workers.getThreadCount();
+
+            for (const auto &cmd : commands) {
+                workers.async([&] {
+                    try {
+                        if (compile(cmd, *opts, tool, main_addr)) {
+                            ++failed;
+                        }
+                    } catch (std::exception &e) {
+                        llvm::errs() << "error: " << cmd.Filename << ": " << e.what() << '\n';
+                        ++failed;
+                    }
+                });
+            }
+
+            workers.wait();
+        }
+
+        set_shared_context_state(nullptr);
+
+        auto elapsed  = std::chrono::duration< double >(clock::now() - start).count();
+        auto compiled = commands.size() - failed;
+        llvm::errs() << llvm::formatv(
+            "vast-front: compiled {0} of {1} translation units in {2:f3} s "
+            "({3:f2} TU/s, {4} jobs)\n",
+            compiled, commands.size(), elapsed, elapsed > 0 ? compiled / elapsed : 0., jobs
+        );
+
+        return failed ? 1 : 0;
+    }
+
+} // namespace vast::cc
@@ -33,8 +33,12 @@ VAST_UNRELAX_WARNINGS
 
 #include "vast/Frontend/CompilerInvocation.hpp"
 #include "vast/Frontend/CompilerInstance.hpp"
+#include "vast/Frontend/Consumer.hpp"
 #include "vast/Frontend/Diagnostics.hpp"
 
+#include <mutex>
+#include <shared_mutex>
+
 using namespace vast::cc;
 
 static void error_handler(void *user_data, const char *msg, bool get_crash_diag) {
@@ -56,17 +60,26 @@ namespace vast::cc {
 
     bool execute_compiler_invocation(compiler_instance *ci, const vast_args &vargs);
 
-    int cc1(const vast_args &vargs, argv_t ccargs, arg_t tool, void *main_addr) {
+    static void initialize_targets() {
+        // Target registry is process wide and not thread-safe, translation
+        // units compiled in the batch mode share the single initialization.
+        static std::once_flag initialized;
+        std::call_once(initialized, [] {
+            llvm::InitializeAllTargets();
+            llvm::InitializeAllTargetMCs();
+            llvm::InitializeAllAsmPrinters();
+            llvm::InitializeAllAsmParsers();
+        });
+    }
+
+    int cc1(const vast_args &vargs, argv_t ccargs, arg_t tool, void *main_addr, bool batch) {
         // FIXME: ensureSufficientStack
 
         auto comp = std::make_unique< compiler_instance >();
         // FIXME: register the support for object-file-wrapped Clang modules.
 
         // Initialize targets first, so that --version shows registered targets.
-        llvm::InitializeAllTargets();
-        llvm::InitializeAllTargetMCs();
-        llvm::InitializeAllAsmPrinters();
-        llvm::InitializeAllAsmParsers();
+        initialize_targets();
 
         vast::cc::buffered_diagnostics diags(ccargs);
 
@@ -101,8 +114,17 @@ namespace vast::cc {
         }
 
         // Set an error handler, so that any LLVM backend diagnostics go through our
-        // error handler.
-        llvm::install_fatal_error_handler(error_handler, static_cast<void*>(&comp->getDiagnostics()));
+        // error handler. The handler is process wide, hence translation units
+        // compiled in the batch mode keep the default one.
+        if (!batch) {
+            llvm::install_fatal_error_handler(error_handler, static_cast<void*>(&comp->getDiagnostics()));
+        }
+
+        // Translation units of the batch mode share the process, so their
+        // resources need to be freed.
+        if (batch) {
+            frontend_opts.DisableFree = false;
+        }
 
         diags.flush();
         if (!success) {
@@ -110,6 +132,19 @@ namespace vast::cc {
             return 1;
         }
 
+        // Translation units of the batch mode are compiled concurrently, the
+        // ones with a non-reentrant backend are compiled alone.
+        static std::shared_mutex backend_mutex;
+        std::shared_lock< std::shared_mutex > shared(backend_mutex, std::defer_lock);
+        std::unique_lock< std::shared_mutex > exclusive(backend_mutex, std::defer_lock);
+        if (batch) {
+            if (is_backend_reentrant(comp->getCodeGenOpts())) {
+                shared.lock();
+            } else {
+                exclusive.lock();
+            }
+        }
+
         // Execute the frontend actions.
         try {
             llvm::TimeTraceScope TimeScope("ExecuteCompiler");
@@ -125,8 +160,10 @@ namespace vast::cc {
 
         // If any timers were active but haven't been destroyed yet, print their
         // results now.  This happens in -disable-free mode.
-        llvm::TimerGroup::printAll(llvm::errs());
-        llvm::TimerGroup::clearAll();
+        if (!batch) {
+            llvm::TimerGroup::printAll(llvm::errs());
+            llvm::TimerGroup::clearAll();
+        }
 
         if (llvm::timeTraceProfilerEnabled()) {
             // It is possible that the compiler instance doesn't own a file manager here
@@ -159,7 +196,9 @@ namespace vast::cc {
         // Our error handler depends on the Diagnostics object, which we're
         // potentially about to delete. Uninstall the handler now so that any
         // later errors use the default handling behavior instead.
-        llvm::remove_fatal_error_handler();
+        if (!batch) {
+            llvm::remove_fatal_error_handler();
+        }
 
         // When running with -disable-free, don't do any destruction or shutdown.
         if (frontend_opts.DisableFree) {
@@ -18,6 +18,11 @@ VAST_UNRELAX_WARNINGS
 namespace vast::cc
 {
     frontend_action_ptr create_frontend_action(const vast_args &vargs) {
+        // Needs to precede `emit_mlir` as it shares its prefix.
+        if (vargs.has_option(opt::emit_mlir_bytecode)) {
+            return std::make_unique< vast::cc::emit_mlir_bytecode_action >(vargs);
+        }
+
         if (vargs.has_option(opt::emit_mlir)) {
             return std::make_unique< vast::cc::emit_mlir_action >(vargs);
         }
@@ -21,7 +21,11 @@ VAST_UNRELAX_WARNINGS
 
 // main frontend method. Lives inside cc1_main.cpp
 namespace vast::cc {
-    extern int cc1(const vast_args & vargs, argv_t argv, arg_t tool, void *main_addr);
+    extern int cc1(const vast_args & vargs, argv_t argv, arg_t tool, void *main_addr, bool batch);
+
+    // batch mode driven by compilation database. Lives inside batch.cpp
+    extern bool is_batch_mode(const argv_storage_base &cmd_args);
+    extern int batch(const argv_storage_base &cmd_args, void *main_addr);
 } // namespace vast::cc
 
 VAST_RELAX_WARNINGS
@@ -68,7 +72,7 @@ static int execute_cc1_tool(vast::cc::argv_storage_base &cmd_args) {
 
     if (tool == "-cc1") {
         auto ccargs_ref = llvm::ArrayRef(ccargs).slice(2);
-        return vast::cc::cc1(vargs, ccargs_ref, cmd_args[0], get_executable_path_ptr);
+        return vast::cc::cc1(vargs, ccargs_ref, cmd_args[0], get_executable_path_ptr, /* batch */ false);
     }
 
     llvm::errs() << "error: unknown integrated tool '" << tool << "'. "
@@ -147,6 +151,13 @@ int main(int argc, char **argv) try {
         }
     }
 
+    if (vast::cc::is_batch_mode(cmd_args)) {
+        VAST_RELAX_WARNINGS
+        void *get_executable_path_ptr = (void *) (intptr_t) get_executable_path;
+        VAST_UNRELAX_WARNINGS
+        return vast::cc::batch(cmd_args, get_executable_path_ptr);
+    }
+
     // Handle options that need handling before the real command line parsing in
     // Driver::BuildCompilation()
     bool canonical_prefixes = has_canonical_prefixes_option(cmd_args);
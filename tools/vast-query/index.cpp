@@ -0,0 +1,260 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#include "vast/query/index.hpp"
+
+VAST_RELAX_WARNINGS
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/JSON.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/xxhash.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Dialect/HighLevel/HighLevelOps.hpp"
+#include "vast/Util/Symbols.hpp"
+
+#include <type_traits>
+
+namespace vast::query {
+
+    namespace {
+
+        constexpr std::int64_t index_version = 1;
+
+        unsigned kind_bit(symbol_kind kind) { return static_cast< unsigned >(kind); }
+
+        unsigned kinds_of(operation op) {
+            unsigned kinds = 0;
+            if (mlir::isa< hl::FuncOp >(op)) {
+                kinds |= kind_bit(symbol_kind::function);
+            }
+            if (mlir::isa< hl::TypeDefOp, hl::TypeDeclOp >(op)) {
+                kinds |= kind_bit(symbol_kind::type);
+            }
+            if (mlir::isa< hl::StructDeclOp >(op)) {
+                kinds |= kind_bit(symbol_kind::record);
+            }
+            if (mlir::isa< hl::VarDeclOp >(op)) {
+                kinds |= kind_bit(symbol_kind::var);
+                if (mlir::isa_and_nonnull< mlir::ModuleOp, hl::TranslationUnitOp >(op->getParentOp())) {
+                    kinds |= kind_bit(symbol_kind::global);
+                }
+            }
+            return kinds;
+        }
+
+        // Names of symbols, that are nested directly in a symbol table and
+        // enclose `op` or are `op` itself, i.e., scopes to which `op` belongs.
+        symbol_index::scopes_t scopes_of(operation op) {
+            symbol_index::scopes_t scopes;
+            for (; op; op = op->getParentOp()) {
+                auto parent = op->getParentOp();
+                if (!parent || !parent->hasTrait< mlir::OpTrait::SymbolTable >()) {
+                    continue;
+                }
+
+                auto name_attr = mlir::SymbolTable::getSymbolAttrName();
+                if (auto name = op->getAttrOfType< mlir::StringAttr >(name_attr)) {
+                    scopes.push_back(name.str());
+                }
+            }
+            return scopes;
+        }
+
+        std::string show_user(operation user) {
+            std::string buff;
+            llvm::raw_string_ostream ss(buff);
+            user->print(ss);
+            ss << util::show_location(*user);
+            return ss.str();
+        }
+
+        llvm::json::Array to_json(const symbol_index::scopes_t &scopes) {
+            llvm::json::Array array;
+            for (const auto &scope : scopes) {
+                array.push_back(scope);
+            }
+            return array;
+        }
+
+        bool from_json(const llvm::json::Array *array, symbol_index::scopes_t &scopes) {
+            if (!array) {
+                return false;
+            }
+
+            for (const auto &value : *array) {
+                auto scope = value.getAsString();
+                if (!scope) {
+                    return false;
+                }
+                scopes.push_back(scope->str());
+            }
+            return true;
+        }
+
+        bool from_json(const llvm::json::Object &object, symbol_index::user_t &user) {
+            auto text = object.getString("text");
+            if (!text) {
+                return false;
+            }
+            user.text = text->str();
+            return from_json(object.getArray("scopes"), user.scopes);
+        }
+
+        bool from_json(const llvm::json::Object &object, symbol_index::symbol_t &symbol) {
+            auto name         = object.getString("name");
+            auto text         = object.getString("text");
+            auto kinds        = object.getInteger("kinds");
+            auto scoped_users = object.getBoolean("scoped_users");
+            auto users        = object.getArray("users");
+            if (!name || !text || !kinds || !scoped_users || !users) {
+                return false;
+            }
+
+            symbol.name         = name->str();
+            symbol.text         = text->str();
+            symbol.kinds        = static_cast< unsigned >(*kinds);
+            symbol.scoped_users = *scoped_users;
+
+            if (!from_json(object.getArray("scopes"), symbol.scopes)) {
+                return false;
+            }
+
+            for (const auto &value : *users) {
+                auto user_object = value.getAsObject();
+                if (!user_object) {
+                    return false;
+                }
+
+                symbol_index::user_t user;
+                if (!from_json(*user_object, user)) {
+                    return false;
+                }
+                symbol.users.push_back(std::move(user));
+            }
+
+            return true;
+        }
+
+    } // namespace
+
+    std::string input_hash(string_ref contents) {
+        return llvm::utohexstr(llvm::xxHash64(contents));
+    }
+
+    symbol_index symbol_index::build(vast_module mod, std::string input_hash) {
+        symbol_index index;
+        index.input_hash = std::move(input_hash);
+
+        util::symbols(mod, [&] (auto symbol) {
+            symbol_t entry;
+            entry.name   = util::symbol_name(symbol).str();
+            entry.text   = util::show_symbol_value(symbol);
+            entry.kinds  = kinds_of(symbol);
+            entry.scopes = scopes_of(symbol);
+            entry.scoped_users = std::is_same_v< decltype(symbol), util::mlir_symbol_interface >;
+
+            util::yield_symbol_users(symbol, mod.getOperation(), [&] (operation user) {
+                entry.users.push_back({ show_user(user), scopes_of(user) });
+            });
+
+            index.symbols.push_back(std::move(entry));
+        });
+
+        index.rebuild_names();
+        return index;
+    }
+
+    std::optional< symbol_index > symbol_index::load(string_ref path) {
+        auto buffer = llvm::MemoryBuffer::getFile(path);
+        if (!buffer) {
+            return std::nullopt;
+        }
+
+        auto json = llvm::json::parse((*buffer)->getBuffer());
+        if (!json) {
+            llvm::consumeError(json.takeError());
+            return std::nullopt;
+        }
+
+        auto object = json->getAsObject();
+        if (!object || object->getInteger("version") != index_version) {
+            return std::nullopt;
+        }
+
+        auto hash    = object->getString("input");
+        auto symbols = object->getArray("symbols");
+        if (!hash || !symbols) {
+            return std::nullopt;
+        }
+
+        symbol_index index;
+        index.input_hash = hash->str();
+        for (const auto &value : *symbols) {
+            auto symbol_object = value.getAsObject();
+            if (!symbol_object) {
+                return std::nullopt;
+            }
+
+            symbol_t symbol;
+            if (!from_json(*symbol_object, symbol)) {
+                return std::nullopt;
+            }
+            index.symbols.push_back(std::move(symbol));
+        }
+
+        index.rebuild_names();
+        return index;
+    }
+
+    logical_result symbol_index::save(string_ref path) const {
+        std::error_code ec;
+        llvm::raw_fd_ostream os(path, ec, llvm::sys::fs::OF_Text);
+        if (ec) {
+            llvm::errs() << "error: cannot write index " << path << ": " << ec.message() << "\n";
+            return mlir::failure();
+        }
+
+        llvm::json::OStream json(os);
+        json.object([&] {
+            json.attribute("version", index_version);
+            json.attribute("input", input_hash);
+            json.attributeArray("symbols", [&] {
+                for (const auto &symbol : symbols) {
+                    json.object([&] {
+                        json.attribute("name", symbol.name);
+                        json.attribute("text", symbol.text);
+                        json.attribute("kinds", static_cast< std::int64_t >(symbol.kinds));
+                        json.attribute("scopes", to_json(symbol.scopes));
+                        json.attribute("scoped_users", symbol.scoped_users);
+                        json.attributeArray("users", [&] {
+                            for (const auto &user : symbol.users) {
+                                json.object([&] {
+                                    json.attribute("text", user.text);
+                                    json.attribute("scopes", to_json(user.scopes));
+                                });
+                            }
+                        });
+                    });
+                }
+            });
+        });
+
+        return mlir::success();
+    }
+
+    llvm::ArrayRef< unsigned > symbol_index::lookup(string_ref name) const {
+        if (auto it = by_name.find(name); it != by_name.end()) {
+            return it->second;
+        }
+        return {};
+    }
+
+    void symbol_index::rebuild_names() {
+        by_name.clear();
+        for (const auto &[idx, symbol] : llvm::enumerate(symbols)) {
+            by_name[symbol.name].push_back(static_cast< unsigned >(idx));
+        }
+    }
+
+} // namespace vast::query
@@ -13,7 +13,9 @@ VAST_RELAX_WARNINGS
 #include "mlir/Tools/mlir-opt/MlirOptMain.h"
 #include "mlir/Parser/Parser.h"
 
+#include "llvm/ADT/StringSwitch.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/JSON.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/ToolOutputFile.h"
 VAST_UNRELAX_WARNINGS
@@ -25,7 +27,12 @@ VAST_UNRELAX_WARNINGS
 #include "vast/Dialect/HighLevel/HighLevelTypes.hpp"
 #include "vast/Dialect/HighLevel/Passes.hpp"
 #include "vast/Util/Common.hpp"
+#include "vast/Util/ModuleLoader.hpp"
 #include "vast/Util/Symbols.hpp"
+#include "vast/query/index.hpp"
+
+#include <functional>
+#include <optional>
 
 using memory_buffer  = std::unique_ptr< llvm::MemoryBuffer >;
 
@@ -73,6 +80,18 @@ namespace vast::cl
             cl::init(""),
             cl::cat(queries)
         };
+        cl::opt< std::string > queries_file{ "queries",
+            cl::desc("Answer queries listed as JSON lines, '-' reads standard input"),
+            cl::value_desc("filename"),
+            cl::init(""),
+            cl::cat(queries)
+        };
+        cl::opt< std::string > index_file{ "index",
+            cl::desc("Answer queries from a sidecar symbol index, built if missing or stale"),
+            cl::value_desc("filename"),
+            cl::init(""),
+            cl::cat(generic)
+        };
     };
     // clang-format on
 
@@ -83,11 +102,93 @@ namespace vast::cl
 
 namespace vast::query
 {
-    bool show_symbols() { return cl::options->show_symbols != cl::show_symbol_type::none; }
+    struct query_t {
+        cl::show_symbol_type show_symbols = cl::show_symbol_type::none;
+        std::string symbol_users;
+        std::string scope;
+
+        bool shows_symbols() const { return show_symbols != cl::show_symbol_type::none; }
+
+        bool shows_symbol_users() const { return !symbol_users.empty(); }
+
+        bool constrained_scope() const { return !scope.empty(); }
+
+        // Whether the query inspects operations nested in function bodies.
+        bool needs_function_bodies() const {
+            switch (show_symbols) {
+                case cl::show_symbol_type::var:
+                case cl::show_symbol_type::all:
+                    return true;
+                default:
+                    return shows_symbol_users();
+            }
+        }
+    };
+
+    using results_t = std::vector< std::string >;
 
-    bool show_symbol_users() { return !cl::options->show_symbol_users.empty(); }
+    query_t query_from_options() {
+        return {
+            .show_symbols = cl::options->show_symbols,
+            .symbol_users = cl::options->show_symbol_users,
+            .scope        = cl::options->scope_name
+        };
+    }
+
+    std::optional< cl::show_symbol_type > parse_symbol_type(string_ref kind) {
+        return llvm::StringSwitch< std::optional< cl::show_symbol_type > >(kind)
+            .Case("functions", cl::show_symbol_type::function)
+            .Case("types", cl::show_symbol_type::type)
+            .Case("records", cl::show_symbol_type::record)
+            .Case("vars", cl::show_symbol_type::var)
+            .Case("globs", cl::show_symbol_type::global)
+            .Case("all", cl::show_symbol_type::all)
+            .Default(std::nullopt);
+    }
+
+    // Parses a query of form {"show-symbols": "vars", "scope": "main"}, keys
+    // are the names of the command line options.
+    llvm::Expected< query_t > parse_query(string_ref line) {
+        auto json = llvm::json::parse(line);
+        if (!json) {
+            return json.takeError();
+        }
+
+        auto object = json->getAsObject();
+        if (!object) {
+            return llvm::createStringError(llvm::inconvertibleErrorCode(), "expected an object");
+        }
 
-    bool constrained_scope() { return !cl::options->scope_name.empty(); }
+        query_t query;
+        for (const auto &[key, value] : *object) {
+            auto str = value.getAsString();
+            if (!str) {
+                return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                    "expected a string value of '%s'", key.str().c_str()
+                );
+            }
+
+            if (key == "show-symbols") {
+                auto kind = parse_symbol_type(*str);
+                if (!kind) {
+                    return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                        "unknown symbol kind '%s'", str->str().c_str()
+                    );
+                }
+                query.show_symbols = *kind;
+            } else if (key == "symbol-users") {
+                query.symbol_users = str->str();
+            } else if (key == "scope") {
+                query.scope = str->str();
+            } else {
+                return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                    "unknown query key '%s'", key.str().c_str()
+                );
+            }
+        }
+
+        return query;
+    }
 
     template< typename... Ts >
     auto is_one_of() {
@@ -102,12 +203,10 @@ namespace vast::query
         };
     }
 
-    void show_value(auto value) {
-        llvm::outs() << util::show_symbol_value(value) << "\n";
-    }
-
-    logical_result do_show_symbols(auto scope) {
-        auto &show_kind = cl::options->show_symbols;
+    logical_result do_show_symbols(const query_t &query, auto scope, results_t &results) {
+        auto show_value = [&](auto value) {
+            results.push_back(util::show_symbol_value(value));
+        };
 
         auto show_if = [=](auto symbol, auto pred) {
             if (pred(symbol))
@@ -138,23 +237,79 @@ namespace vast::query
             };
         };
 
-        util::symbols(scope, filter_kind(show_kind));
+        util::symbols(scope, filter_kind(query.show_symbols));
         return mlir::success();
     }
 
-    logical_result do_show_users(auto scope) {
-        auto &name = cl::options->show_symbol_users;
-        util::yield_users(name.getValue(), scope, [](auto user) {
-            user->print(llvm::outs());
-            llvm::outs() << util::show_location(*user) << "\n";
+    logical_result do_show_users(const query_t &query, auto scope, results_t &results) {
+        util::yield_users(query.symbol_users, scope, [&](auto user) {
+            std::string buff;
+            llvm::raw_string_ostream ss(buff);
+            user->print(ss);
+            ss << util::show_location(*user);
+            results.push_back(ss.str());
         });
 
         return mlir::success();
     }
+
+    //
+    // Queries answered from the sidecar index, without touching the module.
+    //
+    symbol_kind to_symbol_kind(cl::show_symbol_type kind) {
+        switch (kind) {
+            case cl::show_symbol_type::function: return symbol_kind::function;
+            case cl::show_symbol_type::type:     return symbol_kind::type;
+            case cl::show_symbol_type::record:   return symbol_kind::record;
+            case cl::show_symbol_type::var:      return symbol_kind::var;
+            case cl::show_symbol_type::global:   return symbol_kind::global;
+            case cl::show_symbol_type::all:
+            case cl::show_symbol_type::none:     return symbol_kind::none;
+        }
+
+        VAST_UNREACHABLE("unknown symbol type");
+    }
+
+    logical_result answer(const symbol_index &index, const query_t &query, results_t &results) {
+        auto in_query_scope = [&] (const auto &scopes) {
+            return !query.constrained_scope() || in_scope(scopes, query.scope);
+        };
+
+        if (query.shows_symbols()) {
+            bool all  = query.show_symbols == cl::show_symbol_type::all;
+            auto kind = to_symbol_kind(query.show_symbols);
+            for (const auto &symbol : index.symbols) {
+                if ((all || symbol.has_kind(kind)) && in_query_scope(symbol.scopes)) {
+                    results.push_back(symbol.text);
+                }
+            }
+            return mlir::success();
+        }
+
+        if (query.shows_symbol_users()) {
+            for (auto idx : index.lookup(query.symbol_users)) {
+                const auto &symbol = index.symbols[idx];
+                if (!in_query_scope(symbol.scopes)) {
+                    continue;
+                }
+
+                for (const auto &user : symbol.users) {
+                    if (!symbol.scoped_users || in_query_scope(user.scopes)) {
+                        results.push_back(user.text);
+                    }
+                }
+            }
+        }
+
+        return mlir::success();
+    }
 } // namespace vast::query
 
 namespace vast
 {
+    using query::query_t;
+    using query::results_t;
+
     logical_result get_scope_operation(auto parent, std::string_view scope_name, auto yield) {
         auto result =mlir::success();
         util::symbol_tables(parent, [&](mlir::Operation *op) {
@@ -166,45 +321,165 @@ namespace vast
         return result;
     }
 
-    logical_result do_query(mcontext_t &ctx, memory_buffer buffer) {
-        llvm::SourceMgr source_mgr;
-        source_mgr.AddNewSourceBuffer(std::move(buffer), llvm::SMLoc());
-
-        mlir::SourceMgrDiagnosticHandler manager_handler(source_mgr, &ctx);
-
+    std::unique_ptr< module_loader > load_module(mcontext_t &ctx, memory_buffer buffer) {
         // Disable multi-threading when parsing the input file. This removes the
         // unnecessary/costly context synchronization when parsing.
         bool wasThreadingEnabled = ctx.isMultithreadingEnabled();
         ctx.disableMultithreading();
 
-        owning_module_ref mod(mlir::parseSourceFile< vast_module >(source_mgr, &ctx));
+        // Function bodies of bytecode inputs are materialized only if the
+        // query reaches them.
+        auto mod = std::make_unique< module_loader >(ctx, std::move(buffer), /* lazy */ true);
         ctx.enableMultithreading(wasThreadingEnabled);
-        if (!mod) {
+        if (!*mod) {
             llvm::errs() << "error: cannot parse module\n";
-            return mlir::failure();
+            return nullptr;
         }
 
-        auto process_scope = [&] (auto scope) {
-            if (query::show_symbols()) {
-                return query::do_show_symbols(scope);
+        return mod;
+    }
+
+    logical_result answer(module_loader &mod, const query_t &query, results_t &results) {
+        // Scoped queries materialize only the function of the scope.
+        if (!query.constrained_scope() && query.needs_function_bodies()) {
+            if (mlir::failed(mod.materialize_all())) {
+                return mlir::failure();
+            }
+        }
+
+        auto process_scope = [&] (mlir::Operation *scope) {
+            if (mlir::failed(mod.materialize(scope))) {
+                return mlir::failure();
+            }
+
+            if (query.shows_symbols()) {
+                return query::do_show_symbols(query, scope, results);
             }
 
-            if (query::show_symbol_users()) {
-                return query::do_show_users(scope);
+            if (query.shows_symbol_users()) {
+                return query::do_show_users(query, scope, results);
             }
 
             return mlir::success();
         };
 
         mlir::Operation *scope = mod.get();
-        if (query::constrained_scope()) {
-            return get_scope_operation(scope, cl::options->scope_name, process_scope);
+
+        if (query.constrained_scope()) {
+            return get_scope_operation(scope, query.scope, process_scope);
         } else {
             return process_scope(scope);
         }
     }
 
+    using answer_t = std::function< logical_result(const query_t &, results_t &) >;
+
+    // Loads the sidecar index of the input, it is (re)built from the module
+    // and written if it is missing or was built from a different input.
+    std::optional< query::symbol_index > get_index(mcontext_t &ctx, memory_buffer buffer) {
+        auto &path = cl::options->index_file;
+        auto hash  = query::input_hash(buffer->getBuffer());
+
+        if (auto index = query::symbol_index::load(path); index && index->input_hash == hash) {
+            return index;
+        }
+
+        auto mod = load_module(ctx, std::move(buffer));
+        if (!mod || mlir::failed(mod->materialize_all())) {
+            return std::nullopt;
+        }
+
+        auto index = query::symbol_index::build(mod->get(), std::move(hash));
+        if (mlir::failed(index.save(path))) {
+            return std::nullopt;
+        }
+
+        return index;
+    }
+
+    // Answers queries listed as JSON lines, each by a JSON line of results.
+    logical_result run_batch(const answer_t &answer) {
+        std::string err;
+        auto input = mlir::openInputFile(cl::options->queries_file, &err);
+        if (!input) {
+            llvm::errs() << "error: " << err << "\n";
+            return mlir::failure();
+        }
+
+        auto result = mlir::success();
+
+        llvm::SmallVector< string_ref > lines;
+        input->getBuffer().split(lines, '\n', /* max split */ -1, /* keep empty */ false);
+
+        std::int64_t id = 0;
+        for (auto line : lines) {
+            if (line.trim().empty()) {
+                continue;
+            }
+
+            llvm::json::Object response{ { "query", id++ } };
+
+            results_t results;
+            auto query = query::parse_query(line);
+            if (!query) {
+                response["error"] = llvm::toString(query.takeError());
+                result = mlir::failure();
+            } else if (mlir::failed(answer(*query, results))) {
+                response["error"] = "query failed";
+                result = mlir::failure();
+            } else {
+                response["results"] = llvm::json::Array(results);
+            }
+
+            llvm::outs() << llvm::json::Value(std::move(response)) << "\n";
+        }
+
+        return result;
+    }
+
+    logical_result run_single(const answer_t &answer) {
+        results_t results;
+        auto result = answer(query::query_from_options(), results);
+        for (const auto &line : results) {
+            llvm::outs() << line << "\n";
+        }
+        return result;
+    }
+
+    logical_result do_query(mcontext_t &ctx, memory_buffer buffer) {
+        bool batch = !cl::options->queries_file.empty();
+
+        auto run = [&] (const answer_t &answer) {
+            return batch ? run_batch(answer) : run_single(answer);
+        };
+
+        if (!cl::options->index_file.empty()) {
+            auto index = get_index(ctx, std::move(buffer));
+            if (!index) {
+                return mlir::failure();
+            }
+
+            return run([&] (const query_t &query, results_t &results) {
+                return query::answer(*index, query, results);
+            });
+        }
+
+        auto mod = load_module(ctx, std::move(buffer));
+        if (!mod) {
+            return mlir::failure();
+        }
+
+        return run([&] (const query_t &query, results_t &results) {
+            return answer(*mod, query, results);
+        });
+    }
+
     logical_result run(mcontext_t &ctx) {
+        if (cl::options->input_file == "-" && cl::options->queries_file == "-") {
+            llvm::errs() << "error: the input and the queries cannot both be read from stdin\n";
+            return mlir::failure();
+        }
+
         std::string err;
         if (auto input = mlir::openInputFile(cl::options->input_file, &err))
             return do_query(ctx, std::move(input));
@@ -223,8 +498,10 @@ int main(int argc, char **argv) {
     vast::registerAllDialects(registry);
     mlir::registerAllDialects(registry);
 
+    // Upstream dialects are only registered, they are loaded if the input
+    // happens to use them.
     vast::mcontext_t ctx(registry);
-    ctx.loadAllAvailableDialects();
+    vast::loadDefaultDialects(ctx);
 
     std::exit(failed(vast::run(ctx)));
 }
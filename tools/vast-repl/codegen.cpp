@@ -5,81 +5,467 @@
 
 #include "vast/repl/state.hpp"
 
-#include <llvm/Support/Signals.h>
+VAST_RELAX_WARNINGS
+#include <clang/Basic/SourceManager.h>
+#include <clang/Frontend/CompilerInstance.h>
+#include <clang/Frontend/CompilerInvocation.h>
+#include <clang/Lex/Lexer.h>
+#include <clang/Serialization/PCHContainerOperations.h>
+#include <llvm/ADT/DenseSet.h>
+#include <llvm/ADT/StringSet.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/xxhash.h>
+#include <mlir/IR/AttrTypeSubElements.h>
+#include <mlir/IR/Verifier.h>
+VAST_UNRELAX_WARNINGS
 
-#include "vast/CodeGen/CodeGen.hpp"
-#include "vast/Frontend/Action.hpp"
-#include "vast/Frontend/CompilerInstance.hpp"
-#include "vast/Frontend/CompilerInvocation.hpp"
-#include "vast/Frontend/Diagnostics.hpp"
+#include "vast/CodeGen/CodeGenContext.hpp"
+#include "vast/CodeGen/CodeGenDriver.hpp"
+#include "vast/Frontend/Options.hpp"
+#include "vast/Util/Symbols.hpp"
 
-#include <fstream>
+namespace vast::repl::codegen {
 
-namespace vast::cc {
-    bool execute_compiler_invocation(cc::compiler_instance *ci, const cc::vast_args &vargs);
-} // namespace vast::cc
+    namespace {
 
-namespace vast::repl::codegen {
+        std::optional< std::uint64_t > hash_of_file(const std::filesystem::path &path) {
+            auto buffer = llvm::MemoryBuffer::getFile(path.string());
+            if (!buffer) {
+                return std::nullopt;
+            }
+            return llvm::xxHash64((*buffer)->getBuffer());
+        }
 
-    std::unique_ptr< clang::ASTUnit > ast_from_source(string_ref source) {
-        return clang::tooling::buildASTFromCode(source);
-    }
+        string_ref file_name(clang::FileEntryRef file) { return file.getName(); }
+        string_ref file_name(const clang::FileEntry *file) { return file->getName(); }
+
+        // Files the unit was parsed from with hashes of their contents, i.e.,
+        // the main file and all files it includes, also through the preamble.
+        auto dependencies_of(clang::ASTUnit &unit)
+            -> std::vector< std::pair< std::string, std::uint64_t > >
+        {
+            auto &sm = unit.getSourceManager();
+
+            // Files of the preamble are known once their entries are loaded.
+            for (unsigned idx = 0; idx < sm.loaded_sloc_entry_size(); ++idx) {
+                sm.getLoadedSLocEntry(idx);
+            }
+
+            std::vector< std::pair< std::string, std::uint64_t > > dependencies;
+            for (auto it = sm.fileinfo_begin(); it != sm.fileinfo_end(); ++it) {
+                auto path = file_name(it->first).str();
+                if (auto hash = hash_of_file(path)) {
+                    dependencies.emplace_back(std::move(path), *hash);
+                }
+            }
+
+            return dependencies;
+        }
+
+        // Range of the main file text `range` is expanded from.
+        clang::CharSourceRange file_range(const clang::ASTContext &actx, clang::SourceRange range) {
+            const auto &sm = actx.getSourceManager();
+            return clang::Lexer::makeFileCharRange(
+                sm.getExpansionRange(range), sm, actx.getLangOpts()
+            );
+        }
+
+        string_ref source_text(const clang::Decl *decl) {
+            const auto &actx = decl->getASTContext();
+            return clang::Lexer::getSourceText(
+                file_range(actx, decl->getSourceRange()),
+                actx.getSourceManager(), actx.getLangOpts()
+            );
+        }
+
+        bool is_main_file_definition(const clang::FunctionDecl *fn) {
+            const auto &sm = fn->getASTContext().getSourceManager();
+            return fn->doesThisDeclarationHaveABody() && sm.isInMainFile(fn->getLocation());
+        }
+
+        incremental_codegen::fingerprint_t fingerprint(const clang::FunctionDecl *fn) {
+            const auto &sm = fn->getASTContext().getSourceManager();
+            auto begin = sm.getPresumedLoc(sm.getExpansionLoc(fn->getBeginLoc()));
+            return {
+                .text   = llvm::xxHash64(source_text(fn)),
+                .line   = begin.isValid() ? begin.getLine() : 0,
+                .column = begin.isValid() ? begin.getColumn() : 0
+            };
+        }
+
+        // Text of the main file without function bodies, e.g., macros, types
+        // and globals the bodies depend on. Bodies may be reused only if all
+        // of it stays the same.
+        std::uint64_t context_fingerprint(clang::ASTUnit &unit) {
+            const auto &actx = unit.getASTContext();
+            const auto &sm   = actx.getSourceManager();
 
-    static void error_handler(void *user_data, const char *msg, bool get_crash_diag) {
-        auto &diags = *static_cast< clang::DiagnosticsEngine* >(user_data);
+            std::vector< std::pair< unsigned, unsigned > > bodies;
+            for (auto decl : actx.getTranslationUnitDecl()->decls()) {
+                auto fn = clang::dyn_cast< clang::FunctionDecl >(decl);
+                if (!fn || !is_main_file_definition(fn)) {
+                    continue;
+                }
+
+                auto range = file_range(actx, fn->getBody()->getSourceRange());
+                if (range.isValid() && sm.isInMainFile(range.getBegin())) {
+                    bodies.emplace_back(
+                        sm.getFileOffset(range.getBegin()), sm.getFileOffset(range.getEnd())
+                    );
+                }
+            }
+
+            llvm::sort(bodies);
+
+            auto text = sm.getBufferData(sm.getMainFileID());
+
+            std::string context;
+            std::size_t offset = 0;
+            for (auto [begin, end] : bodies) {
+                if (begin < offset) {
+                    continue;
+                }
+                context += text.slice(offset, begin);
+                context += '\0';
+                offset = end;
+            }
+            context += text.substr(offset);
+
+            return llvm::xxHash64(context);
+        }
 
-        diags.Report(clang::diag::err_fe_error_backend) << msg;
+        // Moves locations of `fn` in `file` by `delta` lines, e.g., if lines
+        // were inserted above an otherwise unchanged function.
+        void shift_locations(hl::FuncOp fn, string_ref file, int delta) {
+            if (delta == 0) {
+                return;
+            }
 
-        // Run the interrupt handlers to make sure any special cleanups get done, in
-        // particular that we remove files registered with RemoveFileOnSignal.
-        llvm::sys::RunInterruptHandlers();
+            mlir::AttrTypeReplacer replacer;
+            replacer.addReplacement([&] (mlir::FileLineColLoc loc) -> std::optional< mlir::Attribute > {
+                if (loc.getFilename() != file) {
+                    return std::nullopt;
+                }
+                return mlir::FileLineColLoc::get(
+                    loc.getFilename(), unsigned(int(loc.getLine()) + delta), loc.getColumn()
+                );
+            });
+
+            replacer.recursivelyReplaceElementsIn(
+                fn, /* attrs */ true, /* locs */ true, /* types */ false
+            );
+        }
+
+        // Data layout entries of types used only by reused bodies are not
+        // known to the new codegen, hence they are carried over.
+        void merge_data_layout(vast_module into, vast_module from) {
+            auto name   = core::CoreDialect::getDataLayoutAttrName();
+            auto target = into->getAttrOfType< core::DataLayoutTableAttr >(name);
+            auto source = from->getAttrOfType< core::DataLayoutTableAttr >(name);
+            if (!target || !source) {
+                return;
+            }
+
+            llvm::SmallVector< mlir::DataLayoutEntryInterface > entries(
+                target.getSpec().getEntries()
+            );
+
+            llvm::DenseSet< mlir_type > known;
+            for (auto entry : entries) {
+                if (auto type = entry.getKey().dyn_cast< mlir_type >()) {
+                    known.insert(type);
+                }
+            }
+
+            for (auto entry : source.getSpec().getEntries()) {
+                auto type = entry.getKey().dyn_cast< mlir_type >();
+                if (type && !known.contains(type)) {
+                    entries.push_back(entry);
+                }
+            }
+
+            auto ctx = into.getContext();
+            into->setAttr(name, core::DataLayoutTableAttr::get(
+                ctx, mlir::DataLayoutSpecAttr::get(ctx, entries)
+            ));
+        }
+
+        // Names of symbols and enum constants declared in `mod`.
+        llvm::StringSet<> declared_names(vast_module mod) {
+            llvm::StringSet<> names;
+            util::symbols(mod, [&] (auto symbol) {
+                names.insert(util::symbol_name(symbol));
+            });
+            mod->walk([&] (hl::EnumConstantOp constant) {
+                names.insert(constant.getName());
+            });
+            return names;
+        }
+
+        // The verifier does not check every reference, e.g., callees of
+        // `hl.call`, referenced globals or named types, hence references of
+        // a reused body are resolved one by one.
+        bool resolves_references(hl::FuncOp fn, const llvm::StringSet<> &names) {
+            bool resolved = true;
+            auto resolve = [&] (string_ref name) {
+                resolved = resolved && names.contains(name);
+            };
+
+            mlir::AttrTypeWalker walker;
+            walker.addWalk([&] (mlir::SymbolRefAttr ref) {
+                resolve(ref.getRootReference().getValue());
+            });
+            walker.addWalk([&] (hl::RecordType type) { resolve(type.getName()); });
+            walker.addWalk([&] (hl::EnumType type) { resolve(type.getName()); });
+            walker.addWalk([&] (hl::TypedefType type) { resolve(type.getName()); });
+
+            fn.walk([&] (operation op) {
+                if (auto ref = mlir::dyn_cast< hl::GlobalRefOp >(op)) {
+                    resolve(ref.getGlobal());
+                }
+                if (auto ref = mlir::dyn_cast< hl::EnumRefOp >(op)) {
+                    resolve(ref.getValue());
+                }
+
+                walker.walk(op->getAttrDictionary());
+                for (auto type : op->getResultTypes()) {
+                    walker.walk(type);
+                }
+                for (auto &region : op->getRegions()) {
+                    for (auto &block : region) {
+                        for (auto arg : block.getArguments()) {
+                            walker.walk(arg.getType());
+                        }
+                    }
+                }
+            });
+
+            return resolved;
+        }
+
+    } // namespace
+
+    incremental_codegen::incremental_codegen(mcontext_t &mctx, std::filesystem::path source)
+        : mctx(mctx), source(std::move(source))
+    {}
+
+    incremental_codegen::~incremental_codegen() = default;
+
+    bool incremental_codegen::is_stale() const {
+        if (!unit || dependencies.empty()) {
+            return true;
+        }
+
+        return llvm::any_of(dependencies, [] (const auto &dependency) {
+            return hash_of_file(dependency.first) != dependency.second;
+        });
     }
 
-    owning_module_ref emit_module(const std::filesystem::path &source, mcontext_t */* mctx */) {
-        // TODO setup args from repl state
-        std::vector< const char * > ccargs = { source.c_str() };
-        vast::cc::buffered_diagnostics diags(ccargs);
+    clang::ASTUnit *incremental_codegen::ast() {
+        if (!is_stale()) {
+            return unit.get();
+        }
 
-        auto comp = std::make_unique< cc::compiler_instance >();
+        auto buffer = llvm::MemoryBuffer::getFile(source.string());
+        if (!buffer) {
+            VAST_ERROR("error: cannot read {0}", source.string());
+            return nullptr;
+        }
 
-        auto success = cc::compiler_invocation::create_from_args(
-            comp->getInvocation(), diags.engine, ccargs, "vast-repl"
-        );
+        auto pch = std::make_shared< clang::PCHContainerOperations >();
 
-        // Create the actual diagnostics engine.
-        if (comp->createDiagnostics(); !comp->hasDiagnostics()) {
-            return {};
+        if (unit) {
+            // Remapped buffers are owned by the unit, they make sure that the
+            // current contents are parsed even if the file manager cached the
+            // previous ones.
+            std::vector< clang::ASTUnit::RemappedFile > remapped = {
+                { source.string(), buffer->release() }
+            };
+
+            for (const auto &[path, hash] : dependencies) {
+                if (path == source.string()) {
+                    continue;
+                }
+                if (auto contents = llvm::MemoryBuffer::getFile(path)) {
+                    remapped.emplace_back(path, contents->release());
+                }
+            }
+
+            if (unit->Reparse(pch, remapped)) {
+                VAST_ERROR("error: failed to reparse {0}", source.string());
+                unit.reset();
+            }
+
+            update_dependencies();
+            return unit.get();
         }
 
-        // Set an error handler, so that any LLVM backend diagnostics go through our
-        // error handler.
-        llvm::install_fatal_error_handler(
-            error_handler, static_cast<void*>(&comp->getDiagnostics())
+        // TODO setup args from repl state
+        auto resources = clang::CompilerInvocation::GetResourcesPath(
+            "vast-repl", reinterpret_cast< void * >(&hash_of_file)
         );
 
-        diags.flush();
-        if (!success) {
-            comp->getDiagnosticClient().finish();
-            return {};
+        auto path = source.string();
+        std::vector< const char * > args = { "clang", path.c_str() };
+
+        auto diags = clang::CompilerInstance::createDiagnostics(new clang::DiagnosticOptions());
+
+        // The preamble is precompiled after the first parse, so that headers
+        // are not parsed again on reparse.
+        unit.reset(clang::ASTUnit::LoadFromCommandLine(
+            args.data(), args.data() + args.size(), pch, diags, resources,
+            /* store preambles in memory */ true,
+            /* preamble storage path */ "",
+            /* only local decls */ false,
+            clang::CaptureDiagsKind::None,
+            /* remapped files */ {},
+            /* remapped files keep original name */ true,
+            /* precompile preamble after n parses */ 1
+        ));
+
+        if (!unit) {
+            VAST_ERROR("error: failed to parse {0}", path);
         }
 
+        update_dependencies();
+        return unit.get();
+    }
+
+    void incremental_codegen::update_dependencies() {
+        // Sources with errors stay stale, so that they are parsed again.
+        if (!unit || unit->getDiagnostics().hasErrorOccurred()) {
+            dependencies.clear();
+            return;
+        }
+
+        dependencies = dependencies_of(*unit);
+    }
+
+    owning_module_ref incremental_codegen::generate(const reuse_t &reuse) {
+        auto &actx = unit->getASTContext();
+
+        cc::action_options opts = {
+            .headers = unit->getHeaderSearchOpts(),
+            .codegen = codegen_opts,
+            .target  = actx.getTargetInfo().getTargetOpts(),
+            .lang    = actx.getLangOpts(),
+            .front   = frontend_opts,
+            .diags   = unit->getDiagnostics(),
+            .vfs     = unit->getFileManager().getVirtualFileSystem()
+        };
+
         // TODO setup args from repl state
         cc::vast_args vargs = {};
 
-        comp->LoadRequestedPlugins();
+        cg::codegen_context cgctx(mctx, actx, cc::get_source_language(actx.getLangOpts()));
+        cg::codegen_driver driver(cgctx, opts, vargs);
+        if (reuse) {
+            driver.on_function_definition(reuse);
+        }
+
+        for (auto decl : actx.getTranslationUnitDecl()->decls()) {
+            if (decl->isImplicit()) {
+                continue;
+            }
+            driver.handle_top_level_decl(clang::DeclGroupRef(decl));
+        }
+
+        driver.finalize();
+        return std::move(cgctx.mod);
+    }
+
+    owning_module_ref incremental_codegen::emit(vast_module previous) {
+        if (!ast()) {
+            return {};
+        }
 
-        // If there were errors in processing arguments, don't do anything else.
-        if (comp->getDiagnostics().hasErrorOccurred()) {
+        if (unit->getDiagnostics().hasErrorOccurred()) {
+            VAST_ERROR("error: {0} has errors", source.string());
             return {};
         }
 
-        if (auto action = std::make_unique< vast::cc::emit_mlir_module >(vargs); !action) {
-            comp->ExecuteAction(*action);
-            llvm::remove_fatal_error_handler();
-            return action->result();
+        auto current_context = context_fingerprint(*unit);
+        bool may_reuse = previous && context == current_context;
+
+        struct reused_body
+        {
+            hl::FuncOp fn;
+            hl::FuncOp old;
+            int delta;
+        };
+
+        llvm::StringMap< fingerprint_t > current;
+        llvm::SmallVector< reused_body > reused;
+
+        auto reuse = [&] (hl::FuncOp fn, const clang::FunctionDecl *decl) {
+            if (!is_main_file_definition(decl)) {
+                return false;
+            }
+
+            auto name = fn.getSymName();
+            auto print = fingerprint(decl);
+            current[name] = print;
+
+            if (!may_reuse) {
+                return false;
+            }
+
+            auto it = functions.find(name);
+            if (it == functions.end()) {
+                return false;
+            }
+
+            const auto &last = it->second;
+            if (last.text != print.text || last.column != print.column) {
+                return false;
+            }
+
+            auto old = mlir::dyn_cast_or_null< hl::FuncOp >(
+                mlir::SymbolTable::lookupSymbolIn(previous, name)
+            );
+
+            if (!old || old.isDeclaration()) {
+                return false;
+            }
+
+            reused.push_back({ fn, old, int(print.line) - int(last.line) });
+            return true;
+        };
+
+        auto mod = generate(reuse);
+        if (!mod) {
+            return {};
+        }
+
+        // Bodies are cloned, `previous` stays intact if the module is
+        // generated again from scratch.
+        for (const auto &[fn, old, delta] : reused) {
+            auto clone = old.clone();
+            shift_locations(clone, unit->getMainFileName(), delta);
+            fn.getBody().takeBody(clone.getBody());
+            clone->erase();
+        }
+
+        if (!reused.empty()) {
+            merge_data_layout(mod.get(), previous);
+
+            // Bodies might refer to declarations that only the generation
+            // of the body would have emitted, e.g., of implicit or builtin
+            // functions, start over in such a case.
+            auto names = declared_names(mod.get());
+            auto unresolved = llvm::any_of(reused, [&] (const auto &entry) {
+                return !resolves_references(entry.fn, names);
+            });
+
+            if (unresolved || mlir::failed(mlir::verify(mod.get()))) {
+                context.reset();
+                return emit(nullptr);
+            }
         }
 
-        return {};
+        context   = current_context;
+        functions = std::move(current);
+        return mod;
     }
 
 } // namespace vast::repl::codegen
@@ -4,6 +4,7 @@
 
 #include "vast/Conversion/Passes.hpp"
 #include "vast/Tower/Tower.hpp"
+#include "vast/Util/ModuleLoader.hpp"
 #include "vast/repl/common.hpp"
 #include <optional>
 
@@ -29,13 +30,75 @@ namespace vast::repl::cmd {
         return file_buffer;
     }
 
-    void check_and_emit_module(state_t &state) {
-        if (!state.tower) {
-            check_source(state);
-            auto mod    = codegen::emit_module(state.source.value(), &state.ctx);
-            auto [t, _] = tw::default_tower::get(state.ctx, std::move(mod));
-            state.tower = std::move(t);
+    bool is_mlir_source(const state_t &state) {
+        auto ext = state.source->extension();
+        return ext == ".mlir" || ext == ".mlirbc";
+    }
+
+    owning_module_ref load_module(state_t &state) {
+        auto buff = get_source_buffer(state);
+        if (!buff) {
+            return {};
+        }
+
+        // Passes of the tower run on the whole module, hence it is loaded eagerly.
+        module_loader loader(state.ctx, std::move(buff.get()), /* lazy */ false);
+        if (!loader) {
+            VAST_ERROR("error: cannot parse module {0}", state.source->string());
+            return {};
+        }
+        return loader.take();
+    }
+
+    codegen::incremental_codegen &get_codegen(state_t &state) {
+        check_source(state);
+        if (!state.codegen) {
+            state.codegen = std::make_unique< codegen::incremental_codegen >(
+                state.ctx, state.source.value()
+            );
+        }
+        return *state.codegen;
+    }
+
+    bool check_and_emit_module(state_t &state) {
+        check_source(state);
+
+        if (is_mlir_source(state)) {
+            if (!state.tower) {
+                auto mod = load_module(state);
+                if (!mod) {
+                    return false;
+                }
+
+                auto [t, _] = tw::default_tower::get(state.ctx, std::move(mod));
+                state.tower = std::move(t);
+            }
+            return true;
+        }
+
+        auto &cg = get_codegen(state);
+        if (state.tower && !cg.is_stale()) {
+            return true;
+        }
+
+        // Unchanged functions are moved over from the previous module, levels
+        // built on top of it are dropped.
+        vast_module previous;
+        if (state.tower) {
+            auto bottom = state.tower->bottom();
+            state.tower->materialize(bottom);
+            previous = bottom.mod;
+        }
+
+        auto mod = cg.emit(previous);
+        if (!mod) {
+            VAST_ERROR("error: failed to emit module of {0}", state.source->string());
+            return false;
         }
+
+        auto [t, _] = tw::default_tower::get(state.ctx, std::move(mod));
+        state.tower = std::move(t);
+        return true;
     }
 
     //
@@ -56,7 +119,22 @@ namespace vast::repl::cmd {
     // load command
     //
     void load::run(state_t &state) const {
-        state.source = get_param< source_param >(params).path;
+        auto path = get_param< source_param >(params).path;
+
+        // Loading the same source again drops raised levels, but keeps the
+        // bottom module, so that only functions changed meanwhile are
+        // generated again.
+        if (state.source == path && state.codegen && state.tower) {
+            auto bottom = state.tower->bottom();
+            state.tower->materialize(bottom);
+            auto [t, _] = tw::default_tower::get(state.ctx, owning_module_ref(bottom.mod.clone()));
+            state.tower = std::move(t);
+            return;
+        }
+
+        state.source = path;
+        state.tower.reset();
+        state.codegen.reset();
     };
 
     //
@@ -67,26 +145,74 @@ namespace vast::repl::cmd {
         llvm::outs() << buff.get()->getBuffer() << "\n";
     }
 
-    void show_ast(const state_t &state) {
-        auto buff = get_source_buffer(state);
-        auto unit = codegen::ast_from_source(buff.get()->getBuffer());
-        unit->getASTContext().getTranslationUnitDecl()->dump(llvm::outs());
-        llvm::outs() << "\n";
+    void show_ast(state_t &state) {
+        if (auto unit = get_codegen(state).ast()) {
+            unit->getASTContext().getTranslationUnitDecl()->dump(llvm::outs());
+            llvm::outs() << "\n";
+        }
     }
 
     void show_module(state_t &state) {
-        check_and_emit_module(state);
+        if (!check_and_emit_module(state)) {
+            return;
+        }
         llvm::outs() << state.tower->top().mod << "\n";
     }
 
     void show_symbols(state_t &state) {
-        check_and_emit_module(state);
+        if (!check_and_emit_module(state)) {
+            return;
+        }
 
         util::symbols(state.tower->top().mod, [&] (auto symbol) {
             llvm::outs() << util::show_symbol_value(symbol) << "\n";
         });
     }
 
+    // Prints functions of each level, whether their bodies are shared with a
+    // child level and how many of their operations link to the parent level.
+    void show_tower(state_t &state) {
+        if (!check_and_emit_module(state)) {
+            return;
+        }
+
+        auto &tower = *state.tower;
+        for (std::size_t id = 0; id < tower.size(); ++id) {
+            auto level  = tower.level(id);
+            auto parent = tower.parent(level);
+
+            llvm::outs() << "level " << id;
+            if (parent) {
+                llvm::outs() << " from " << parent->id;
+            }
+            llvm::outs() << "\n";
+
+            level.mod->walk< mlir::WalkOrder::PreOrder >([&] (operation op) {
+                auto fn = mlir::dyn_cast< mlir::FunctionOpInterface >(op);
+                if (!fn) {
+                    return mlir::WalkResult::advance();
+                }
+
+                auto name = mlir::SymbolTable::getSymbolName(fn).getValue();
+                llvm::outs() << "  @" << name;
+                if (tower.is_shared(level, name)) {
+                    llvm::outs() << " shared";
+                } else if (parent && !fn.isExternal()) {
+                    std::size_t ops = 0, linked = 0;
+                    fn.getFunctionBody().walk([&] (operation nested) {
+                        ++ops;
+                        linked += tower.prev(level, nested) != nullptr;
+                    });
+                    llvm::outs() << " links: "
+                                 << (linked == ops ? "all" : linked ? "some" : "none");
+                }
+                llvm::outs() << "\n";
+
+                return mlir::WalkResult::skip();
+            });
+        }
+    }
+
     void show::run(state_t &state) const {
         auto what = get_param< kind_param >(params);
         switch (what) {
@@ -94,6 +220,7 @@ namespace vast::repl::cmd {
             case show_kind::ast:     return show_ast(state);
             case show_kind::module:  return show_module(state);
             case show_kind::symbols: return show_symbols(state);
+            case show_kind::tower:   return show_tower(state);
         }
     };
 
@@ -122,7 +249,9 @@ namespace vast::repl::cmd {
     }
 
     void meta::run(state_t &state) const {
-        check_and_emit_module(state);
+        if (!check_and_emit_module(state)) {
+            return;
+        }
 
         auto action  = get_param< action_param >(params);
         switch (action) {
@@ -135,7 +264,9 @@ namespace vast::repl::cmd {
     // raise command
     //
     void raise::run(state_t &state) const {
-        check_and_emit_module(state);
+        if (!check_and_emit_module(state)) {
+            return;
+        }
 
         std::string pipeline = get_param< pipeline_param >(params).value;
         llvm::SmallVector< llvm::StringRef, 2 > passes;
@@ -64,6 +64,9 @@ namespace vast::repl
                 }
 
                 cli.exec(cmd);
+                // Output of a command is complete before the next one is
+                // read, e.g., if commands are piped.
+                llvm::outs().flush();
 
                 linenoise::AddHistory(cmd.c_str());
                 linenoise::SaveHistory(path);
@@ -95,7 +98,7 @@ int main(int argc, char **argv) try {
     args_t args = load_args(argc, argv);
 
     vast::mcontext_t ctx(registry);
-    ctx.loadAllAvailableDialects();
+    vast::loadDefaultDialects(ctx);
 
     auto prompt = vast::repl::prompt(ctx);
 